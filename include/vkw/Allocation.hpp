@@ -25,6 +25,10 @@ public:
                      VkDeviceSize size) noexcept(ExceptionsDisabled) = 0;
   virtual void invalidate(VkDeviceSize offset,
                           VkDeviceSize size) noexcept(ExceptionsDisabled) = 0;
+#ifdef VK_VERSION_1_2
+  /// Address of buffer allocation or 0 if allocator cannot resolve it.
+  virtual VkDeviceAddress deviceAddress() const noexcept { return 0; }
+#endif
 
   virtual ~DeviceAllocationBase() = default;
 };
@@ -99,8 +103,13 @@ template <> struct AllocatableObjectTraits<VkBuffer> {
 class DefaultDeviceAllocation final : public DeviceAllocationBase {
 public:
   DefaultDeviceAllocation(
-      VmaAllocator allocator, const AllocationCreateInfo &allocInfo,
+      Device const &device, VmaAllocator allocator,
+      const AllocationCreateInfo &allocInfo,
       VkBufferCreateInfo const &createInfo) noexcept(ExceptionsDisabled) {
+#ifdef VK_VERSION_1_2
+    if (createInfo.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+      m_device = &device;
+#endif
     VkBuffer tmpBuf{};
     VmaAllocation tmpAlloc{};
     VK_CHECK_RESULT(vmaCreateBuffer(allocator, &createInfo, &allocInfo, &tmpBuf,
@@ -154,6 +163,11 @@ public:
     VK_CHECK_RESULT(vmaInvalidateAllocation(m_allocator(), m_allocation.get(),
                                             offset, size));
   }
+#ifdef VK_VERSION_1_2
+  VkDeviceAddress deviceAddress() const noexcept override {
+    return m_device ? m_device->bufferDeviceAddress(getBuffer()) : 0;
+  }
+#endif
 
   VkImage getImage() const {
     return std::get<VkImage>(m_allocation.get_deleter().objectHandle);
@@ -188,6 +202,8 @@ private:
   };
   std::unique_ptr<VmaAllocation_T, AllocDeleter> m_allocation;
   VmaAllocationInfo m_allocInfo{};
+  // Set only for buffers with SHADER_DEVICE_ADDRESS usage.
+  Device const *m_device = nullptr;
 };
 
 class DefaultDeviceAllocator final : public DeviceAllocator {
@@ -202,7 +218,12 @@ public:
           if (std::ranges::any_of(
                   device.physicalDevice().enabledExtensions(),
                   [](auto &id) { return id == ext::EXT_memory_budget; }))
-            allocatorInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+            allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+#ifdef VK_VERSION_1_2
+          if (device.physicalDevice().bufferDeviceAddressEnabled())
+            allocatorInfo.flags |=
+                VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+#endif
 
           VmaVulkanFunctions vmaVulkanFunctions{};
           vmaVulkanFunctions.vkGetInstanceProcAddr =
@@ -249,8 +270,8 @@ private:
   m_allocateBuffer(const AllocationCreateInfo &allocInfo,
                    VkBufferCreateInfo const
                        &createInfo) noexcept(ExceptionsDisabled) override {
-    auto ret = std::make_unique<DefaultDeviceAllocation>(m_impl.get(),
-                                                         allocInfo, createInfo);
+    auto ret = std::make_unique<DefaultDeviceAllocation>(
+        parent(), m_impl.get(), allocInfo, createInfo);
     auto buf = ret->getBuffer();
     return {buf, std::move(ret)};
   }
@@ -294,13 +315,15 @@ public:
   Allocation &operator=(Allocation &&) noexcept = default;
 
   bool mappable() const noexcept {
-    auto bits = m_pimpl->properties().VkMemoryPropertyFlags;
-    return bits & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ||
-           bits & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    return m_pimpl->properties() & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
   }
 
   bool coherent() const noexcept {
-    auto bits = m_pimpl->properties().VkMemoryPropertyFlags;
+    return m_pimpl->properties() & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  }
+
+  VkMemoryPropertyFlags memoryProperties() const noexcept {
+    return m_pimpl->properties();
   }
 
   auto allocationSize() const noexcept { return m_pimpl->size(); }
@@ -326,10 +349,20 @@ public:
     m_pimpl->invalidate(offset, size);
   }
 
+#ifdef VKW_COMPACT_OBJECTS
+  // Allocations are never deleted through base pointer.
+  ~Allocation() = default;
+#else
   virtual ~Allocation() = default;
+#endif
 
 protected:
   ObjT handle() const { return m_handle; }
+#ifdef VK_VERSION_1_2
+  VkDeviceAddress deviceAddress() const noexcept {
+    return m_pimpl->deviceAddress();
+  }
+#endif
 
 private:
   ObjT m_handle = nullptr;
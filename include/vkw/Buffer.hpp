@@ -5,12 +5,27 @@
 
 namespace vkw {
 
+namespace __detail {
+#ifdef VKW_COMPACT_OBJECTS
+// Only part of create info that is used after buffer creation.
+struct BufferInfo {
+  BufferInfo(VkBufferCreateInfo const &createInfo) noexcept
+      : size(createInfo.size), usage(createInfo.usage) {}
+  VkDeviceSize size;
+  VkBufferUsageFlags usage;
+};
+#else
+using BufferInfo = VkBufferCreateInfo;
+#endif
+} // namespace __detail
+
 class BufferBase : public Allocation<VkBuffer>, public ReferenceGuard {
 public:
   BufferBase(
       DeviceAllocator &allocator, VkBufferCreateInfo const &createInfo,
       AllocationCreateInfo const &allocCreateInfo) noexcept(ExceptionsDisabled)
-      : Allocation<VkBuffer>(allocator, allocCreateInfo, createInfo) {}
+      : Allocation<VkBuffer>(allocator, allocCreateInfo, createInfo),
+        m_createInfo(createInfo) {}
 
   auto bufferSize() const noexcept { return m_createInfo.size; }
 
@@ -42,8 +57,18 @@ public:
     return m_createInfo.usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
   }
 
+#ifdef VK_VERSION_1_2
+  /// Address of the buffer, 0 unless it has SHADER_DEVICE_ADDRESS usage.
+  /// It is queried on every call, so it should be cached by hot code.
+  VkDeviceAddress deviceAddress() const noexcept {
+    if (!(m_createInfo.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT))
+      return 0;
+    return Allocation::deviceAddress();
+  }
+#endif
+
 protected:
-  VkBufferCreateInfo m_createInfo;
+  __detail::BufferInfo m_createInfo;
 };
 
 template <typename T> class Buffer : public BufferBase {
@@ -52,12 +77,11 @@ public:
          AllocationCreateInfo const &allocCreateInfo,
          SharingInfo const &sharingInfo = {}) noexcept(ExceptionsDisabled)
       : BufferBase(allocator, m_fillInfo(count, usage, sharingInfo),
-                   allocCreateInfo),
-        m_count(count) {}
+                   allocCreateInfo) {}
 
   std::span<T> mapped() const noexcept { return Allocation::mapped<T>(); }
 
-  uint64_t size() const noexcept { return m_count; }
+  uint64_t size() const noexcept { return bufferSize() / sizeof(T); }
 
 private:
   VkBufferCreateInfo m_fillInfo(uint64_t count, VkBufferUsageFlags usage,
@@ -74,8 +98,45 @@ private:
     createInfo.pNext = nullptr;
     return createInfo;
   }
-  uint64_t m_count;
 };
 
+#ifdef VK_VERSION_1_2
+/**
+ * @class DevicePointer
+ *
+ * is a typed device address of T. It has the layout of a bare 64-bit
+ * address, so it can be stored in push constants and buffers and read as
+ * buffer_reference in shaders.
+ */
+template <typename T> class DevicePointer {
+public:
+  DevicePointer() noexcept = default;
+
+  explicit DevicePointer(VkDeviceAddress address) noexcept
+      : m_address(address) {}
+
+  explicit DevicePointer(Buffer<T> const &buffer, uint64_t index = 0) noexcept
+      : m_address(buffer.deviceAddress()) {
+    assert(m_address && "buffer has no device address");
+    m_address += index * sizeof(T);
+  }
+
+  VkDeviceAddress address() const noexcept { return m_address; }
+
+  explicit operator bool() const noexcept { return m_address != 0; }
+
+  DevicePointer operator+(int64_t offset) const noexcept {
+    return DevicePointer{m_address + offset * sizeof(T)};
+  }
+
+  bool operator==(DevicePointer const &another) const noexcept = default;
+
+private:
+  VkDeviceAddress m_address = 0;
+};
+
+static_assert(sizeof(DevicePointer<float>) == sizeof(VkDeviceAddress));
+#endif
+
 } // namespace vkw
 #endif // VKRENDERER_BUFFER_HPP
@@ -0,0 +1,165 @@
+#ifndef VKWRAPPER_BUFFERUPDATEBATCH_HPP
+#define VKWRAPPER_BUFFERUPDATEBATCH_HPP
+
+#include <vkw/CommandRecorder.hpp>
+#include <vkw/StagingBuffer.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace vkw {
+
+/**
+ * @class BufferUpdateBatch
+ *
+ * collects small writes to device buffers and records all of them at once
+ * followed by a single memory barrier.
+ *
+ * Writes not larger than inline threshold whose offset and size are
+ * multiples of 4 go into command buffer with vkCmdUpdateBuffer. Others
+ * are packed into one staging buffer and copied with one vkCmdCopyBuffer
+ * per destination buffer.
+ *
+ * Writes of one batch must not overlap since they are not ordered against
+ * each other. Staging buffer is reused between batches, so record() must
+ * not be called again until commands recorded by previous call complete.
+ * Use one batch per frame in flight.
+ */
+class BufferUpdateBatch {
+public:
+  static constexpr VkDeviceSize MaxInlineSize = 65536;
+
+  explicit BufferUpdateBatch(DeviceAllocator &allocator,
+                             VkDeviceSize inlineThreshold = 256) noexcept
+      : m_allocator(allocator),
+        m_inlineThreshold(std::min(inlineThreshold, MaxInlineSize)) {}
+
+  void update(BufferBase const &dst, VkDeviceSize offset,
+              std::span<const unsigned char> data) noexcept(
+      ExceptionsDisabled) {
+    assert(dst.canBeCopyDst() && "buffer is not a transfer destination");
+    if (data.empty())
+      return;
+
+    auto kind = data.size() <= m_inlineThreshold && offset % 4 == 0 &&
+                        data.size() % 4 == 0
+                    ? Kind::INLINE
+                    : Kind::STAGED;
+    auto &bytes = kind == Kind::INLINE ? m_inlineData : m_stagedData;
+    auto position = m_alignUp(bytes.size());
+    bytes.resize(position + data.size());
+    std::memcpy(bytes.data() + position, data.data(), data.size());
+
+    m_ops.push_back(Op{&dst, kind, offset, data.size(), position, 0});
+  }
+
+  template <typename T>
+  void update(BufferBase const &dst, VkDeviceSize offset,
+              T const &value) noexcept(ExceptionsDisabled) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    update(dst, offset,
+           {reinterpret_cast<unsigned char const *>(&value), sizeof(T)});
+  }
+
+  /// Fills range with repeated 4 byte value. Offset must be multiple of 4,
+  /// size must be multiple of 4 or VK_WHOLE_SIZE.
+  void fill(BufferBase const &dst, VkDeviceSize offset, VkDeviceSize size,
+            uint32_t value) noexcept {
+    assert(offset % 4 == 0 && (size == VK_WHOLE_SIZE || size % 4 == 0) &&
+           "invalid fill range");
+    m_ops.push_back(Op{&dst, Kind::FILL, offset, size, 0, value});
+  }
+
+  bool empty() const noexcept { return m_ops.empty(); }
+
+  /**
+   * Records all collected writes and a barrier making them visible to
+   * dstStage/dstAccess.
+   */
+  void record(TransferPassRecorder &recorder, VkPipelineStageFlags dstStage,
+              VkAccessFlags dstAccess) noexcept(ExceptionsDisabled) {
+    if (m_ops.empty())
+      return;
+
+    if (!m_stagedData.empty()) {
+      if (!m_staging || m_staging->size() < m_stagedData.size())
+        m_staging.emplace(m_allocator.get(),
+                          std::bit_ceil(m_stagedData.size()));
+      std::memcpy(m_staging->mapped().data(), m_stagedData.data(),
+                  m_stagedData.size());
+      m_staging->flush(0, m_stagedData.size());
+    }
+
+    // Group staged copies by destination so that each buffer gets a single
+    // copy command.
+    std::stable_sort(m_ops.begin(), m_ops.end(),
+                     [](Op const &lhs, Op const &rhs) {
+                       return std::less<>{}(lhs.dst, rhs.dst);
+                     });
+
+    cntr::vector<VkBufferCopy, 16> regions;
+    for (auto op = m_ops.begin(); op != m_ops.end(); ++op) {
+      switch (op->kind) {
+      case Kind::INLINE:
+        recorder.updateBuffer(
+            *op->dst, op->offset,
+            std::span(m_inlineData).subspan(op->position, op->size));
+        break;
+      case Kind::FILL:
+        recorder.fillBuffer(*op->dst, op->offset, op->size, op->fillValue);
+        break;
+      case Kind::STAGED:
+        regions.push_back(VkBufferCopy{op->position, op->offset, op->size});
+        break;
+      }
+
+      auto next = std::next(op);
+      if (!regions.empty() && (next == m_ops.end() || next->dst != op->dst)) {
+        recorder.copyBufferToBuffer(*m_staging, *op->dst, regions);
+        regions.clear();
+      }
+    }
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = dstAccess;
+    recorder.memoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage,
+                           {&barrier, 1});
+
+    m_ops.clear();
+    m_inlineData.clear();
+    m_stagedData.clear();
+  }
+
+private:
+  enum class Kind { INLINE, STAGED, FILL };
+
+  struct Op {
+    BufferBase const *dst;
+    Kind kind;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    // Position of data in inline or staged bytes.
+    VkDeviceSize position;
+    uint32_t fillValue;
+  };
+
+  static size_t m_alignUp(size_t position) noexcept {
+    return (position + 3) & ~size_t(3);
+  }
+
+  std::reference_wrapper<DeviceAllocator> m_allocator;
+  VkDeviceSize m_inlineThreshold;
+  std::vector<Op> m_ops;
+  std::vector<unsigned char> m_inlineData;
+  std::vector<unsigned char> m_stagedData;
+  std::optional<StagingBuffer<unsigned char>> m_staging;
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_BUFFERUPDATEBATCH_HPP
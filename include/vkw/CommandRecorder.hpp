@@ -2,18 +2,22 @@
 
 #include <vkw/CommandBuffer.hpp>
 #include <vkw/DescriptorSet.hpp>
+#include <vkw/Event.hpp>
 #include <vkw/FrameBuffer.hpp>
 #include <vkw/Pipeline.hpp>
 #include <vkw/Query.hpp>
 #include <vkw/RenderPass.hpp>
 #include <vkw/VertexBuffer.hpp>
 
+#include <array>
+
 namespace vkw {
 
 class BasicRecorder {
 public:
   BasicRecorder(CommandBuffer &buffer)
-      : m_symbols(&buffer.parent().parent().core<1, 0>()), m_buffer(buffer){};
+      : m_device(&buffer.parent().parent()),
+        m_symbols(&buffer.parent().parent().core<1, 0>()), m_buffer(buffer){};
   BasicRecorder(BasicRecorder &&) noexcept = default;
   BasicRecorder &operator=(BasicRecorder &&) noexcept = default;
   BasicRecorder(const BasicRecorder &) = delete;
@@ -65,6 +69,61 @@ public:
     pipelineBarrier(srcStage, dstStage, memBarriers, {}, {}, flags);
   }
 
+  /** Split barriers **/
+
+  /// Signals event once all commands before it reach stage. Not allowed
+  /// inside of render pass, same as resetEvent().
+  void setEvent(Event const &event, VkPipelineStageFlags stage) noexcept {
+    m_symbols->vkCmdSetEvent(m_buffer, event, stage);
+  }
+
+  void resetEvent(Event const &event, VkPipelineStageFlags stage) noexcept {
+    m_symbols->vkCmdResetEvent(m_buffer, event, stage);
+  }
+
+  /**
+   * Waits for events and applies barriers. srcStage must include stages
+   * events were set with. Only commands before setEvent() are ordered
+   * against commands after the wait.
+   */
+  template <forward_range_of<Event> T>
+  void waitEvents(T const &events, VkPipelineStageFlags srcStage,
+                  VkPipelineStageFlags dstStage,
+                  std::span<const VkMemoryBarrier> memBarriers,
+                  std::span<const VkImageMemoryBarrier> imageMemoryBarrier,
+                  std::span<const VkBufferMemoryBarrier>
+                      bufferMemoryBarrier) noexcept(ExceptionsDisabled) {
+    auto eventsSubrange = ranges::make_subrange<Event>(events);
+    using eventsSubrangeT = decltype(eventsSubrange);
+
+    cntr::vector<VkEvent, 4> rawEvents{};
+    std::transform(eventsSubrange.begin(), eventsSubrange.end(),
+                   std::back_inserter(rawEvents),
+                   [](auto const &event) -> VkEvent {
+                     return eventsSubrangeT::get(event);
+                   });
+
+    m_symbols->vkCmdWaitEvents(
+        m_buffer, rawEvents.size(), rawEvents.data(), srcStage, dstStage,
+        memBarriers.size(), memBarriers.data(), bufferMemoryBarrier.size(),
+        bufferMemoryBarrier.data(), imageMemoryBarrier.size(),
+        imageMemoryBarrier.data());
+  }
+
+  void waitEvent(Event const &event, VkPipelineStageFlags srcStage,
+                 VkPipelineStageFlags dstStage,
+                 std::span<const VkMemoryBarrier> memBarriers,
+                 std::span<const VkImageMemoryBarrier> imageMemoryBarrier,
+                 std::span<const VkBufferMemoryBarrier>
+                     bufferMemoryBarrier) noexcept {
+    VkEvent rawEvent = event;
+    m_symbols->vkCmdWaitEvents(
+        m_buffer, 1, &rawEvent, srcStage, dstStage, memBarriers.size(),
+        memBarriers.data(), bufferMemoryBarrier.size(),
+        bufferMemoryBarrier.data(), imageMemoryBarrier.size(),
+        imageMemoryBarrier.data());
+  }
+
   /** Query **/
   void resetQuery(const QueryPool &queryPool, uint32_t firstQuery,
                   uint32_t count) noexcept {
@@ -83,10 +142,84 @@ public:
     m_symbols->vkCmdEndQuery(m_buffer, queryPool, query);
   }
 
+  /** Debug labels **/
+
+  // Labels are recorded only if library is built with VKW_ENABLE_DEBUG_LABELS
+  // and instance has VK_EXT_debug_utils enabled. Otherwise these calls are
+  // empty and compile away.
+
+  void beginLabel([[maybe_unused]] char const *name,
+                  [[maybe_unused]] std::array<float, 4> color = {}) noexcept {
+#ifdef VKW_ENABLE_DEBUG_LABELS
+    if (!m_device->m_cmdBeginLabel)
+      return;
+    auto label = m_label(name, color);
+    m_device->m_cmdBeginLabel(m_buffer, &label);
+#endif
+  }
+
+  void endLabel() noexcept {
+#ifdef VKW_ENABLE_DEBUG_LABELS
+    if (m_device->m_cmdEndLabel)
+      m_device->m_cmdEndLabel(m_buffer);
+#endif
+  }
+
+  void insertLabel([[maybe_unused]] char const *name,
+                   [[maybe_unused]] std::array<float, 4> color = {}) noexcept {
+#ifdef VKW_ENABLE_DEBUG_LABELS
+    if (!m_device->m_cmdInsertLabel)
+      return;
+    auto label = m_label(name, color);
+    m_device->m_cmdInsertLabel(m_buffer, &label);
+#endif
+  }
+
+  /// Label region that ends with the scope.
+  class LabelScope {
+  public:
+    LabelScope(BasicRecorder &recorder, char const *name,
+               std::array<float, 4> color = {}) noexcept
+        : m_recorder(recorder) {
+      m_recorder.beginLabel(name, color);
+    }
+    LabelScope(LabelScope const &) = delete;
+    LabelScope &operator=(LabelScope const &) = delete;
+    ~LabelScope() { m_recorder.endLabel(); }
+
+  private:
+    BasicRecorder &m_recorder;
+  };
+
+  /**
+   * e.g.:
+   *    {
+   *      auto scope = recorder.labelScope("shadow pass");
+   *      ...
+   *    }
+   */
+  [[nodiscard]] LabelScope
+  labelScope(char const *name, std::array<float, 4> color = {}) noexcept {
+    return {*this, name, color};
+  }
+
+  Device const &device() const noexcept { return *m_device; }
+
   virtual ~BasicRecorder() = default;
 
 protected:
   friend class BufferRecorder;
+#ifdef VKW_ENABLE_DEBUG_LABELS
+  static VkDebugUtilsLabelEXT m_label(char const *name,
+                                      std::array<float, 4> color) noexcept {
+    VkDebugUtilsLabelEXT label{};
+    label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+    label.pLabelName = name;
+    std::copy(color.begin(), color.end(), label.color);
+    return label;
+  }
+#endif
+  Device const *m_device;
   DeviceCore<1, 0> const *m_symbols;
   VkCommandBuffer m_buffer;
 };
@@ -143,6 +276,17 @@ public:
                                        dynamicOffsets.data());
   }
 
+  /// Binds raw sets, dynamicOffsets are given in set and binding order.
+  void bindDescriptorSets(VkPipelineLayout layout,
+                          VkPipelineBindPoint bindPoint,
+                          std::span<const VkDescriptorSet> sets,
+                          uint32_t firstSet,
+                          std::span<const uint32_t> dynamicOffsets) noexcept {
+    m_symbols->vkCmdBindDescriptorSets(
+        m_buffer, bindPoint, layout, firstSet, sets.size(), sets.data(),
+        dynamicOffsets.size(), dynamicOffsets.data());
+  }
+
   template <typename T>
   void pushConstant(PipelineLayout const &layout,
                     VkShaderStageFlagBits shaderStage, uint32_t offset,
@@ -159,6 +303,13 @@ public:
                                   sizeof(T) * constantSpan.size(),
                                   constantSpan.data());
   }
+
+  void pushConstants(VkPipelineLayout layout, VkShaderStageFlags stages,
+                     uint32_t offset,
+                     std::span<const unsigned char> bytes) noexcept {
+    m_symbols->vkCmdPushConstants(m_buffer, layout, stages, offset,
+                                  bytes.size(), bytes.data());
+  }
 };
 
 // FIXME: multiple subpasses are unsupported.
@@ -190,6 +341,11 @@ public:
     m_symbols->vkCmdBindPipeline(m_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                                  pipeline);
   }
+  void bindPipeline(VkPipeline pipeline) noexcept {
+    m_symbols->vkCmdBindPipeline(m_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                 pipeline);
+  }
+
   /** Vertex/index buffer binding **/
 
   template <typename T>
@@ -206,6 +362,16 @@ public:
     m_symbols->vkCmdBindIndexBuffer(m_buffer, buffer, offset, type);
   }
 
+  void bindVertexBuffer(VkBuffer buffer, uint32_t binding,
+                        VkDeviceSize offset) noexcept {
+    m_symbols->vkCmdBindVertexBuffers(m_buffer, binding, 1, &buffer, &offset);
+  }
+
+  void bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset,
+                       VkIndexType type) noexcept {
+    m_symbols->vkCmdBindIndexBuffer(m_buffer, buffer, offset, type);
+  }
+
   /** Draw commands */
 
   void draw(uint32_t vertexCount, uint32_t instanceCount = 0,
@@ -221,6 +387,69 @@ public:
                                 vertexOffset, firstInstance);
   }
 
+#ifdef VK_EXT_multi_draw
+  /**
+   * Issues one draw per element of vertexInfo with shared instance range.
+   * Uses vkCmdDrawMultiEXT if multi draw is enabled on the device and loops
+   * vkCmdDraw otherwise.
+   */
+  void drawMulti(std::span<const VkMultiDrawInfoEXT> vertexInfo,
+                 uint32_t instanceCount = 1,
+                 uint32_t firstInstance = 0) noexcept {
+    if (!m_device->m_cmdDrawMulti) {
+      for (auto const &info : vertexInfo)
+        draw(info.vertexCount, instanceCount, info.firstVertex, firstInstance);
+      return;
+    }
+    for (auto chunk = vertexInfo; !chunk.empty();) {
+      auto count = std::min<size_t>(chunk.size(), MultiDrawChunkSize);
+      m_device->m_cmdDrawMulti(m_buffer, count, chunk.data(), instanceCount,
+                               firstInstance, sizeof(VkMultiDrawInfoEXT));
+      chunk = chunk.subspan(count);
+    }
+  }
+
+  /**
+   * Indexed variant of drawMulti(). If vertexOffset is set it overrides
+   * vertexOffset of every element of indexInfo.
+   */
+  void drawMultiIndexed(std::span<const VkMultiDrawIndexedInfoEXT> indexInfo,
+                        uint32_t instanceCount = 1, uint32_t firstInstance = 0,
+                        std::optional<int32_t> vertexOffset = {}) noexcept {
+    if (!m_device->m_cmdDrawMultiIndexed) {
+      for (auto const &info : indexInfo)
+        drawIndexed(info.indexCount, instanceCount, info.firstIndex,
+                    vertexOffset.value_or(info.vertexOffset), firstInstance);
+      return;
+    }
+    for (auto chunk = indexInfo; !chunk.empty();) {
+      auto count = std::min<size_t>(chunk.size(), MultiDrawChunkSize);
+      m_device->m_cmdDrawMultiIndexed(
+          m_buffer, count, chunk.data(), instanceCount, firstInstance,
+          sizeof(VkMultiDrawIndexedInfoEXT),
+          vertexOffset ? &*vertexOffset : nullptr);
+      chunk = chunk.subspan(count);
+    }
+  }
+#endif
+
+  /** drawCount > 1 requires multiDrawIndirect feature. */
+  void drawIndirect(IndirectBuffer<VkDrawIndirectCommand> const &buffer,
+                    uint32_t drawCount, uint32_t firstDraw = 0) noexcept {
+    m_symbols->vkCmdDrawIndirect(
+        m_buffer, buffer, firstDraw * sizeof(VkDrawIndirectCommand), drawCount,
+        sizeof(VkDrawIndirectCommand));
+  }
+
+  /** drawCount > 1 requires multiDrawIndirect feature. */
+  void drawIndexedIndirect(
+      IndirectBuffer<VkDrawIndexedIndirectCommand> const &buffer,
+      uint32_t drawCount, uint32_t firstDraw = 0) noexcept {
+    m_symbols->vkCmdDrawIndexedIndirect(
+        m_buffer, buffer, firstDraw * sizeof(VkDrawIndexedIndirectCommand),
+        drawCount, sizeof(VkDrawIndexedIndirectCommand));
+  }
+
   /** Pipeline dynamic state sets */
 
   void setScissors(std::span<const VkRect2D> scissors,
@@ -235,6 +464,11 @@ public:
   }
 
 private:
+#ifdef VK_EXT_multi_draw
+  // Guaranteed minimum of maxMultiDrawCount.
+  static constexpr size_t MultiDrawChunkSize = 1024;
+#endif
+
   friend class BufferRecorder;
   RenderPassRecorder(PrimaryCommandBuffer &buffer,
                      const FrameBuffer &frameBuffer, VkRect2D renderArea,
@@ -341,6 +575,21 @@ public:
                               blits.size(), blits.data(), filter);
   }
 
+  /// Inline update of at most 65536 bytes, offset and size must be
+  /// multiples of 4.
+  void updateBuffer(BufferBase const &dst, VkDeviceSize offset,
+                    std::span<const unsigned char> data) noexcept {
+    assert(offset % 4 == 0 && data.size() % 4 == 0 && data.size() <= 65536 &&
+           "invalid inline buffer update");
+    m_symbols->vkCmdUpdateBuffer(m_buffer, dst, offset, data.size(),
+                                 data.data());
+  }
+
+  void fillBuffer(BufferBase const &dst, VkDeviceSize offset,
+                  VkDeviceSize size, uint32_t data) noexcept {
+    m_symbols->vkCmdFillBuffer(m_buffer, dst, offset, size, data);
+  }
+
 private:
   friend class BufferRecorder;
   TransferPassRecorder(CommandBuffer &buffer) : BasicRecorder(buffer) {}
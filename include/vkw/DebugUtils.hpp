@@ -0,0 +1,82 @@
+#ifndef VKWRAPPER_DEBUGUTILS_HPP
+#define VKWRAPPER_DEBUGUTILS_HPP
+
+#include <vkw/Buffer.hpp>
+#include <vkw/Device.hpp>
+#include <vkw/Image.hpp>
+
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace vkw {
+
+/**
+ * Object names make handles readable in validation messages, debuggers and
+ * GPU capture tools. Like command buffer labels (see BasicRecorder), names
+ * are set only if library is built with VKW_ENABLE_DEBUG_LABELS and instance
+ * has VK_EXT_debug_utils enabled. Otherwise setObjectName() is empty.
+ *
+ * Buffers and images do not keep their device, so it is passed explicitly.
+ *
+ * e.g.:
+ *    setObjectName(pipeline, "terrain");
+ *    setObjectName(device, vertexBuffer, "terrain vertices");
+ */
+
+namespace __detail {
+
+template <typename T> uint64_t m_handleBits(T handle) noexcept {
+  // Non-dispatchable handles are plain integers on 32-bit platforms.
+  if constexpr (std::is_pointer_v<T>)
+    return reinterpret_cast<uintptr_t>(handle);
+  else
+    return static_cast<uint64_t>(handle);
+}
+
+} // namespace __detail
+
+template <typename T>
+  requires std::same_as<typename VulkanTypeTraits<T>::CreatorType, Device>
+inline void setObjectName([[maybe_unused]] Unique<T> const &object,
+                          [[maybe_unused]] char const *name) noexcept {
+#ifdef VKW_ENABLE_DEBUG_LABELS
+  object.parent().setObjectName(VulkanTypeTraits<T>::objectType,
+                                __detail::m_handleBits(static_cast<T>(object)),
+                                name);
+#endif
+}
+
+inline void setObjectName([[maybe_unused]] Device const &device,
+                          [[maybe_unused]] char const *name) noexcept {
+#ifdef VKW_ENABLE_DEBUG_LABELS
+  device.setObjectName(VK_OBJECT_TYPE_DEVICE,
+                       __detail::m_handleBits(static_cast<VkDevice>(device)),
+                       name);
+#endif
+}
+
+/// Names raw handle of any type that has VulkanTypeTraits<>.
+template <typename T>
+  requires requires { VulkanTypeTraits<T>::objectType; }
+inline void setObjectName([[maybe_unused]] Device const &device,
+                          [[maybe_unused]] T handle,
+                          [[maybe_unused]] char const *name) noexcept {
+#ifdef VKW_ENABLE_DEBUG_LABELS
+  device.setObjectName(VulkanTypeTraits<T>::objectType,
+                       __detail::m_handleBits(handle), name);
+#endif
+}
+
+inline void setObjectName(Device const &device, BufferBase const &buffer,
+                          char const *name) noexcept {
+  setObjectName(device, static_cast<VkBuffer>(buffer), name);
+}
+
+inline void setObjectName(Device const &device, ImageInterface const &image,
+                          char const *name) noexcept {
+  setObjectName(device, static_cast<VkImage>(image), name);
+}
+
+} // namespace vkw
+#endif // VKWRAPPER_DEBUGUTILS_HPP
@@ -3,6 +3,7 @@
 
 #include <vkw/Containers.hpp>
 #include <vkw/Device.hpp>
+#include <vkw/Expected.hpp>
 
 #include <span>
 
@@ -49,6 +50,15 @@ public:
 private:
   VkDescriptorSet
   allocateSet(VkDescriptorSetLayout layout) noexcept(ExceptionsDisabled) {
+    auto set = try_allocateSet(layout);
+    if (!set)
+      VK_CHECK_RESULT(set.error())
+
+    return set.value_or(VK_NULL_HANDLE);
+  }
+
+  Expected<VkDescriptorSet>
+  try_allocateSet(VkDescriptorSetLayout layout) noexcept {
     VkDescriptorSetAllocateInfo allocateInfo{};
     allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocateInfo.pNext = nullptr;
@@ -57,8 +67,10 @@ private:
     allocateInfo.pSetLayouts = &layout;
 
     VkDescriptorSet set;
-    VK_CHECK_RESULT(parent().core<1, 0>().vkAllocateDescriptorSets(
-        parent(), &allocateInfo, &set))
+    auto result = parent().core<1, 0>().vkAllocateDescriptorSets(
+        parent(), &allocateInfo, &set);
+    if (result != VK_SUCCESS)
+      return Unexpected{result};
 
     m_setCount++;
 
@@ -128,11 +128,18 @@ class DescriptorSet : public ReferenceGuard {
 public:
   DescriptorSet(DescriptorPool &pool,
                 DescriptorSetLayout const &layout) noexcept(ExceptionsDisabled)
-      : m_layout(layout), m_set(pool.allocateSet(layout), pool) {
-    for (auto const &binding : layout.bindings()) {
-      if (binding.hasDynamicOffset())
-        m_dynamicOffsets.emplace_back(binding.binding);
-    }
+      : DescriptorSet(pool, layout, pool.allocateSet(layout)) {}
+
+  /**
+   * Allocates set without posting errors. Exhausted pool gives
+   * VK_ERROR_OUT_OF_POOL_MEMORY or VK_ERROR_FRAGMENTED_POOL.
+   */
+  static Expected<DescriptorSet>
+  try_create(DescriptorPool &pool, DescriptorSetLayout const &layout) noexcept {
+    auto set = pool.try_allocateSet(layout);
+    if (!set)
+      return Unexpected{set.error()};
+    return DescriptorSet{pool, layout, *set};
   }
 
   struct DynamicOffset {
@@ -231,6 +238,15 @@ protected:
   }
 
 private:
+  DescriptorSet(DescriptorPool &pool, DescriptorSetLayout const &layout,
+                VkDescriptorSet set) noexcept
+      : m_layout(layout), m_set(set, pool) {
+    for (auto const &binding : layout.bindings()) {
+      if (binding.hasDynamicOffset())
+        m_dynamicOffsets.emplace_back(binding.binding);
+    }
+  }
+
   cntr::vector<DynamicOffset, 2> m_dynamicOffsets{};
 
   StrongReference<DescriptorSetLayout const> m_layout;
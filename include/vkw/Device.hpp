@@ -11,6 +11,7 @@ namespace vkw {
 template <> struct VulkanTypeTraits<VkDevice> {
   using CreatorType = vkw::Instance;
   using CreateInfoType = std::pair<VkPhysicalDevice, VkDeviceCreateInfo>;
+  static constexpr VkObjectType objectType = VK_OBJECT_TYPE_DEVICE;
   static PFN_vkCreateDevice getConstructor(vkw::Instance const &creator);
   static PFN_vkDestroyDevice getDestructor(vkw::Instance const &creator);
 };
@@ -106,12 +107,7 @@ public:
 
     m_createInfo.enabledExtensionCount = m_enabledExtensionsRaw.size();
     m_createInfo.ppEnabledExtensionNames = m_enabledExtensionsRaw.data();
-#ifdef VK_VERSION_1_2
-    if (phDevice.requestedApiVersion() >= ApiVersion(1, 1, 0))
-      m_createInfo.pNext = &m_ph_device.enabledVulkan11Features();
-    else
-      m_createInfo.pNext = nullptr;
-#endif
+    m_createInfo.pNext = m_ph_device.m_linkEnabledFeatures();
 
     m_apiVer = m_ph_device.requestedApiVersion();
   }
@@ -149,7 +145,52 @@ public:
     VK_CHECK_RESULT(core<1, 0>().vkDeviceWaitIdle(handle()))
   }
 
+  VkFormatProperties formatProperties(VkFormat format) const noexcept {
+    VkFormatProperties ret{};
+    parent().core<1, 0>().vkGetPhysicalDeviceFormatProperties(
+        physicalDevice(), format, &ret);
+    return ret;
+  }
+
+#ifdef VK_VERSION_1_2
+  /// Returns address of buffer created with SHADER_DEVICE_ADDRESS usage.
+  VkDeviceAddress bufferDeviceAddress(VkBuffer buffer) const noexcept {
+    assert(m_getBufferDeviceAddress && "bufferDeviceAddress is not enabled");
+    VkBufferDeviceAddressInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    info.buffer = buffer;
+    return m_getBufferDeviceAddress(handle(), &info);
+  }
+#endif
+
+#ifdef VK_EXT_multi_draw
+  /// True if VK_EXT_multi_draw is enabled along with multiDraw feature.
+  bool multiDrawEnabled() const noexcept { return m_cmdDrawMulti; }
+#endif
+
+#ifdef VKW_ENABLE_DEBUG_LABELS
+  /// True if instance has VK_EXT_debug_utils enabled.
+  bool debugLabelsEnabled() const noexcept { return m_setObjectName; }
+
+  /// Names object for debuggers and capture tools. No-op if debug labels
+  /// are not enabled.
+  void setObjectName(VkObjectType type, uint64_t handle,
+                     char const *name) const noexcept {
+    if (!m_setObjectName)
+      return;
+    VkDebugUtilsObjectNameInfoEXT info{};
+    info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+    info.objectType = type;
+    info.objectHandle = handle;
+    info.pObjectName = name;
+    m_setObjectName(this->handle(), &info);
+  }
+#endif
+
 private:
+  friend class BasicRecorder;
+  friend class RenderPassRecorder;
+
   template <unsigned major = 1, unsigned minor = 0>
   static std::unique_ptr<DeviceCore<1, 0>>
   loadDeviceSymbols(vkw::Instance const &instance, VkDevice device,
@@ -175,6 +216,19 @@ private:
   }
 
   std::unique_ptr<DeviceCore<1, 0>> m_coreDeviceSymbols;
+#ifdef VK_VERSION_1_2
+  PFN_vkGetBufferDeviceAddress m_getBufferDeviceAddress = nullptr;
+#endif
+#ifdef VK_EXT_multi_draw
+  PFN_vkCmdDrawMultiEXT m_cmdDrawMulti = nullptr;
+  PFN_vkCmdDrawMultiIndexedEXT m_cmdDrawMultiIndexed = nullptr;
+#endif
+#ifdef VKW_ENABLE_DEBUG_LABELS
+  PFN_vkSetDebugUtilsObjectNameEXT m_setObjectName = nullptr;
+  PFN_vkCmdBeginDebugUtilsLabelEXT m_cmdBeginLabel = nullptr;
+  PFN_vkCmdEndDebugUtilsLabelEXT m_cmdEndLabel = nullptr;
+  PFN_vkCmdInsertDebugUtilsLabelEXT m_cmdInsertLabel = nullptr;
+#endif
 };
 
 inline Device::Device(Instance const &instance,
@@ -183,7 +237,47 @@ inline Device::Device(Instance const &instance,
       vk::Device(instance, std::pair<VkPhysicalDevice, VkDeviceCreateInfo>(
                                physicalDevice(), info())),
       m_coreDeviceSymbols(loadDeviceSymbols(
-          parent(), handle(), physicalDevice().requestedApiVersion())) {}
+          parent(), handle(), physicalDevice().requestedApiVersion())) {
+#ifdef VK_VERSION_1_2
+  if (physicalDevice().bufferDeviceAddressEnabled()) {
+    if (apiVersion() >= ApiVersion(1, 2, 0))
+      m_getBufferDeviceAddress = core<1, 2>().vkGetBufferDeviceAddress;
+    else
+      m_getBufferDeviceAddress =
+          reinterpret_cast<PFN_vkGetBufferDeviceAddress>(
+              core<1, 0>().vkGetDeviceProcAddr(handle(),
+                                               "vkGetBufferDeviceAddressKHR"));
+  }
+#endif
+#ifdef VK_EXT_multi_draw
+  auto const *multiDraw =
+      physicalDevice().enabledFeatures<VkPhysicalDeviceMultiDrawFeaturesEXT>(
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT);
+  if (physicalDevice().isExtensionEnabled(ext::EXT_multi_draw) && multiDraw &&
+      multiDraw->multiDraw) {
+    m_cmdDrawMulti = reinterpret_cast<PFN_vkCmdDrawMultiEXT>(
+        core<1, 0>().vkGetDeviceProcAddr(handle(), "vkCmdDrawMultiEXT"));
+    m_cmdDrawMultiIndexed = reinterpret_cast<PFN_vkCmdDrawMultiIndexedEXT>(
+        core<1, 0>().vkGetDeviceProcAddr(handle(),
+                                         "vkCmdDrawMultiIndexedEXT"));
+  }
+#endif
+#ifdef VKW_ENABLE_DEBUG_LABELS
+  if (parent().isExtensionEnabled(ext::EXT_debug_utils)) {
+    auto load = [this](char const *name) {
+      return core<1, 0>().vkGetDeviceProcAddr(handle(), name);
+    };
+    m_setObjectName = reinterpret_cast<PFN_vkSetDebugUtilsObjectNameEXT>(
+        load("vkSetDebugUtilsObjectNameEXT"));
+    m_cmdBeginLabel = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(
+        load("vkCmdBeginDebugUtilsLabelEXT"));
+    m_cmdEndLabel = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(
+        load("vkCmdEndDebugUtilsLabelEXT"));
+    m_cmdInsertLabel = reinterpret_cast<PFN_vkCmdInsertDebugUtilsLabelEXT>(
+        load("vkCmdInsertDebugUtilsLabelEXT"));
+  }
+#endif
+}
 
 #define VKW_GENERATE_TYPE_FUNC_IMPL
 #include "vkw/VulkanTypeTraits.inc"
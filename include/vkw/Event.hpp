@@ -0,0 +1,48 @@
+#ifndef VKWRAPPER_EVENT_HPP
+#define VKWRAPPER_EVENT_HPP
+
+#include <vkw/Device.hpp>
+
+namespace vkw {
+
+/**
+ * @class Event
+ *
+ * is used to split pipeline barriers: command buffer sets event after
+ * producing commands and waits for it right before consuming ones, so that
+ * work recorded in between is not blocked. Event can also be set, reset and
+ * polled from the host.
+ */
+class Event : public vk::Event {
+public:
+  Event(Device const &device) noexcept(ExceptionsDisabled)
+      : vk::Event(device, [&]() {
+          VkEventCreateInfo createInfo{};
+          createInfo.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+          createInfo.pNext = nullptr;
+          createInfo.flags = 0;
+          return createInfo;
+        }()) {}
+
+  void set() noexcept(ExceptionsDisabled) {
+    VK_CHECK_RESULT(parent().core<1, 0>().vkSetEvent(parent(), handle()))
+  }
+
+  void reset() noexcept(ExceptionsDisabled) {
+    VK_CHECK_RESULT(parent().core<1, 0>().vkResetEvent(parent(), handle()))
+  }
+
+  bool signaled() const noexcept(ExceptionsDisabled) {
+    auto result = parent().core<1, 0>().vkGetEventStatus(parent(), handle());
+    if (result == VK_EVENT_SET)
+      return true;
+    if (result == VK_EVENT_RESET)
+      return false;
+    VK_CHECK_RESULT(result)
+
+    return false;
+  }
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_EVENT_HPP
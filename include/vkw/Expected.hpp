@@ -0,0 +1,127 @@
+#ifndef VKWRAPPER_EXPECTED_HPP
+#define VKWRAPPER_EXPECTED_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <cassert>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#include <expected>
+#endif
+
+namespace vkw {
+
+/**
+ * Result of try_* functions: a value or VkResult the call failed with.
+ *
+ * try_* functions report every failure this way instead of postError(). They
+ * never throw and never build error messages, so expected failures (e.g.
+ * VK_ERROR_OUT_OF_POOL_MEMORY, VK_ERROR_OUT_OF_DATE_KHR) can be handled in
+ * hot loops at the cost of a branch.
+ *
+ * Expected<T> is std::expected<T, VkResult> when standard library has it.
+ * Otherwise minimal replacement with the same basic interface is used:
+ * has_value(), operator bool, operator*, operator->, value(), error() and
+ * value_or(). Unlike std::expected, replacement value() does not throw.
+ *
+ * e.g.:
+ *    auto set = DescriptorSet::try_create(pool, layout);
+ *    if (!set && set.error() == VK_ERROR_OUT_OF_POOL_MEMORY)
+ *      ... allocate new pool ...
+ */
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+
+template <typename T> using Expected = std::expected<T, VkResult>;
+
+using Unexpected = std::unexpected<VkResult>;
+
+#else
+
+class Unexpected {
+public:
+  constexpr explicit Unexpected(VkResult error) noexcept : m_error(error) {}
+
+  constexpr VkResult error() const noexcept { return m_error; }
+
+private:
+  VkResult m_error;
+};
+
+template <typename T> class Expected {
+public:
+  constexpr Expected(T value) noexcept(
+      std::is_nothrow_move_constructible_v<T>)
+      : m_value(std::move(value)) {}
+
+  constexpr Expected(Unexpected error) noexcept : m_error(error.error()) {
+    assert(m_error != VK_SUCCESS && "error must not be VK_SUCCESS");
+  }
+
+  constexpr bool has_value() const noexcept { return m_value.has_value(); }
+
+  constexpr explicit operator bool() const noexcept { return has_value(); }
+
+  constexpr T &operator*() & noexcept { return *m_value; }
+  constexpr T const &operator*() const & noexcept { return *m_value; }
+  constexpr T &&operator*() && noexcept { return *std::move(m_value); }
+
+  constexpr T *operator->() noexcept { return &*m_value; }
+  constexpr T const *operator->() const noexcept { return &*m_value; }
+
+  constexpr T &value() & noexcept {
+    assert(has_value() && "accessing value of failed result");
+    return *m_value;
+  }
+  constexpr T const &value() const & noexcept {
+    assert(has_value() && "accessing value of failed result");
+    return *m_value;
+  }
+  constexpr T &&value() && noexcept {
+    assert(has_value() && "accessing value of failed result");
+    return *std::move(m_value);
+  }
+
+  constexpr VkResult error() const noexcept { return m_error; }
+
+  template <typename U> constexpr T value_or(U &&defaultValue) const & {
+    return has_value() ? *m_value
+                       : static_cast<T>(std::forward<U>(defaultValue));
+  }
+
+private:
+  std::optional<T> m_value;
+  VkResult m_error = VK_SUCCESS;
+};
+
+template <> class Expected<void> {
+public:
+  constexpr Expected() noexcept = default;
+
+  constexpr Expected(Unexpected error) noexcept : m_error(error.error()) {
+    assert(m_error != VK_SUCCESS && "error must not be VK_SUCCESS");
+  }
+
+  constexpr bool has_value() const noexcept { return m_error == VK_SUCCESS; }
+
+  constexpr explicit operator bool() const noexcept { return has_value(); }
+
+  constexpr void operator*() const noexcept {}
+
+  constexpr void value() const noexcept {
+    assert(has_value() && "accessing value of failed result");
+  }
+
+  constexpr VkResult error() const noexcept { return m_error; }
+
+private:
+  VkResult m_error = VK_SUCCESS;
+};
+
+#endif
+
+} // namespace vkw
+#endif // VKWRAPPER_EXPECTED_HPP
@@ -3,6 +3,7 @@
 
 #include <concepts>
 #include <vkw/Device.hpp>
+#include <vkw/Expected.hpp>
 
 namespace vkw {
 
@@ -41,6 +42,18 @@ public:
     return wait_impl(parent(), &h, 1, true, timeout);
   }
 
+  /// Same as wait(), but device errors are returned instead of posted.
+  Expected<bool> try_wait(uint64_t timeout = UINT64_MAX) const noexcept {
+    auto h = handle();
+    auto result = parent().core<1, 0>().vkWaitForFences(parent(), 1, &h,
+                                                        VK_TRUE, timeout);
+    if (result == VK_SUCCESS)
+      return true;
+    if (result == VK_TIMEOUT)
+      return false;
+    return Unexpected{result};
+  }
+
   bool signaled() const noexcept(ExceptionsDisabled) {
     auto result = parent().core<1, 0>().vkGetFenceStatus(parent(), handle());
     if (result == VK_SUCCESS)
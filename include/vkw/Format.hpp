@@ -0,0 +1,238 @@
+#ifndef VKWRAPPER_FORMAT_HPP
+#define VKWRAPPER_FORMAT_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace vkw {
+
+/** Compression scheme of block-compressed formats as named in vk.xml. */
+enum class FormatCompression : uint8_t {
+  NONE,
+#define VKW_DUMP_FORMAT_COMPRESSIONS
+#define VKW_FORMAT_COMPRESSION_ENTRY(X) X,
+#include "vkw/FormatTable.inc"
+#undef VKW_FORMAT_COMPRESSION_ENTRY
+#undef VKW_DUMP_FORMAT_COMPRESSIONS
+};
+
+/** Numeric format of the first component of a format as named in vk.xml. */
+enum class FormatNumeric : uint8_t {
+  NONE,
+#define VKW_DUMP_FORMAT_NUMERICS
+#define VKW_FORMAT_NUMERIC_ENTRY(X) X,
+#include "vkw/FormatTable.inc"
+#undef VKW_FORMAT_NUMERIC_ENTRY
+#undef VKW_DUMP_FORMAT_NUMERICS
+};
+
+/**
+ * @struct FormatInfo
+ *
+ * Properties of a VkFormat as described by the format section of vk.xml.
+ * Bits of compressed components are reported as 0. For multi-planar
+ * formats blockSize describes a single texel of all planes together.
+ */
+struct FormatInfo {
+  VkFormat format = VK_FORMAT_UNDEFINED;
+  uint8_t blockSize = 0;
+  uint8_t texelsPerBlock = 0;
+  uint8_t blockWidth = 1;
+  uint8_t blockHeight = 1;
+  uint8_t blockDepth = 1;
+  uint8_t redBits = 0;
+  uint8_t greenBits = 0;
+  uint8_t blueBits = 0;
+  uint8_t alphaBits = 0;
+  uint8_t depthBits = 0;
+  uint8_t stencilBits = 0;
+  uint8_t planeCount = 0;
+  FormatCompression compression = FormatCompression::NONE;
+  FormatNumeric numeric = FormatNumeric::NONE;
+  VkImageAspectFlags aspects = 0;
+
+  constexpr bool compressed() const noexcept {
+    return compression != FormatCompression::NONE;
+  }
+
+  constexpr bool hasDepth() const noexcept {
+    return aspects & VK_IMAGE_ASPECT_DEPTH_BIT;
+  }
+
+  constexpr bool hasStencil() const noexcept {
+    return aspects & VK_IMAGE_ASPECT_STENCIL_BIT;
+  }
+
+  constexpr bool isDepthStencil() const noexcept {
+    return aspects & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
+  }
+};
+
+namespace __detail {
+
+inline constexpr FormatInfo m_formatTable[] = {
+    FormatInfo{},
+#define VKW_DUMP_FORMATS
+#define VKW_FORMAT_ENTRY(NAME, BLOCK_SIZE, TEXELS, BW, BH, BD, R, G, B, A, D,  \
+                         S, ASPECTS, PLANES, COMPRESSION, NUMERIC)             \
+  FormatInfo{NAME,                                                             \
+             BLOCK_SIZE,                                                       \
+             TEXELS,                                                           \
+             BW,                                                               \
+             BH,                                                               \
+             BD,                                                               \
+             R,                                                                \
+             G,                                                                \
+             B,                                                                \
+             A,                                                                \
+             D,                                                                \
+             S,                                                                \
+             PLANES,                                                           \
+             FormatCompression::COMPRESSION,                                   \
+             FormatNumeric::NUMERIC,                                           \
+             ASPECTS},
+#include "vkw/FormatTable.inc"
+#undef VKW_FORMAT_ENTRY
+#undef VKW_DUMP_FORMATS
+};
+
+// VkFormat values are not contiguous: core formats occupy [0, N) and
+// extension formats are encoded as 1000000000 + (extension - 1) * 1000 +
+// offset. Lookup is done with two small index tables that are built at
+// compile time, so it costs a couple of loads regardless of the format.
+
+inline constexpr uint32_t m_extensionEnumBase = 1000000000u;
+inline constexpr uint32_t m_extensionEnumBlock = 1000u;
+
+constexpr bool m_isExtensionFormat(uint32_t value) noexcept {
+  return value >= m_extensionEnumBase;
+}
+
+constexpr uint32_t m_extensionIndex(uint32_t value) noexcept {
+  return (value - m_extensionEnumBase) / m_extensionEnumBlock;
+}
+
+constexpr uint32_t m_extensionOffset(uint32_t value) noexcept {
+  return value % m_extensionEnumBlock;
+}
+
+struct FormatTableLimits {
+  uint32_t coreCount = 0;
+  uint32_t extensionCount = 0;
+  uint32_t offsetCount = 0;
+  uint32_t slotCount = 1;
+};
+
+inline constexpr FormatTableLimits m_formatTableLimits = []() {
+  FormatTableLimits ret{};
+  for (auto i = std::begin(m_formatTable); i != std::end(m_formatTable); ++i) {
+    auto value = static_cast<uint32_t>(i->format);
+    if (!m_isExtensionFormat(value)) {
+      ret.coreCount = std::max(ret.coreCount, value + 1);
+      continue;
+    }
+    auto extension = m_extensionIndex(value);
+    ret.extensionCount = std::max(ret.extensionCount, extension + 1);
+    ret.offsetCount = std::max(ret.offsetCount, m_extensionOffset(value) + 1);
+    // Every extension that defines formats gets its own slot.
+    if (std::none_of(std::begin(m_formatTable), i, [&](auto const &prev) {
+          auto prevValue = static_cast<uint32_t>(prev.format);
+          return m_isExtensionFormat(prevValue) &&
+                 m_extensionIndex(prevValue) == extension;
+        }))
+      ret.slotCount++;
+  }
+  return ret;
+}();
+
+inline constexpr auto m_coreFormatIndex = []() {
+  std::array<uint16_t, m_formatTableLimits.coreCount> ret{};
+  for (uint16_t i = 0; i < std::size(m_formatTable); ++i) {
+    auto value = static_cast<uint32_t>(m_formatTable[i].format);
+    if (!m_isExtensionFormat(value))
+      ret.at(value) = i;
+  }
+  return ret;
+}();
+
+// Maps extension index to a row of m_extensionFormatIndex. Row 0 is all
+// zeroes and is shared by every extension that defines no formats.
+inline constexpr auto m_extensionFormatSlot = []() {
+  std::array<uint8_t, m_formatTableLimits.extensionCount> ret{};
+  uint8_t nextSlot = 1;
+  for (auto const &info : m_formatTable) {
+    auto value = static_cast<uint32_t>(info.format);
+    if (!m_isExtensionFormat(value))
+      continue;
+    auto &slot = ret.at(m_extensionIndex(value));
+    if (slot == 0)
+      slot = nextSlot++;
+  }
+  return ret;
+}();
+
+inline constexpr auto m_extensionFormatIndex = []() {
+  std::array<std::array<uint16_t, m_formatTableLimits.offsetCount>,
+             m_formatTableLimits.slotCount>
+      ret{};
+  for (uint16_t i = 0; i < std::size(m_formatTable); ++i) {
+    auto value = static_cast<uint32_t>(m_formatTable[i].format);
+    if (!m_isExtensionFormat(value))
+      continue;
+    auto slot = m_extensionFormatSlot.at(m_extensionIndex(value));
+    ret.at(slot).at(m_extensionOffset(value)) = i;
+  }
+  return ret;
+}();
+
+} // namespace __detail
+
+/**
+ * Returns properties of the format. Formats unknown to the registry the
+ * library was generated from yield the VK_FORMAT_UNDEFINED entry.
+ */
+constexpr FormatInfo const &formatInfo(VkFormat format) noexcept {
+  using namespace __detail;
+  auto value = static_cast<uint32_t>(format);
+  if (value < m_formatTableLimits.coreCount)
+    return m_formatTable[m_coreFormatIndex[value]];
+
+  if (!m_isExtensionFormat(value) ||
+      m_extensionIndex(value) >= m_formatTableLimits.extensionCount ||
+      m_extensionOffset(value) >= m_formatTableLimits.offsetCount)
+    return m_formatTable[0];
+
+  auto slot = m_extensionFormatSlot[m_extensionIndex(value)];
+  return m_formatTable[m_extensionFormatIndex[slot][m_extensionOffset(value)]];
+}
+
+/** Number of texel blocks needed to cover extent. */
+constexpr VkExtent3D formatBlockCount(VkFormat format,
+                                      VkExtent3D extent) noexcept {
+  auto const &info = formatInfo(format);
+  return VkExtent3D{(extent.width + info.blockWidth - 1u) / info.blockWidth,
+                    (extent.height + info.blockHeight - 1u) / info.blockHeight,
+                    (extent.depth + info.blockDepth - 1u) / info.blockDepth};
+}
+
+/** Size in bytes of one tightly packed row of texel blocks. */
+constexpr VkDeviceSize formatRowPitch(VkFormat format,
+                                      uint32_t width) noexcept {
+  auto const &info = formatInfo(format);
+  return VkDeviceSize((width + info.blockWidth - 1u) / info.blockWidth) *
+         info.blockSize;
+}
+
+/** Size in bytes of tightly packed texel data covering extent. */
+constexpr VkDeviceSize formatDataSize(VkFormat format,
+                                      VkExtent3D extent) noexcept {
+  auto blocks = formatBlockCount(format, extent);
+  return VkDeviceSize(blocks.width) * blocks.height * blocks.depth *
+         formatInfo(format).blockSize;
+}
+
+} // namespace vkw
+#endif // VKWRAPPER_FORMAT_HPP
@@ -0,0 +1,291 @@
+#ifndef VKWRAPPER_HOSTIMAGECOPY_HPP
+#define VKWRAPPER_HOSTIMAGECOPY_HPP
+
+#include <vkw/CommandRecorder.hpp>
+#include <vkw/Extensions.hpp>
+#include <vkw/Format.hpp>
+#include <vkw/StagingBuffer.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <optional>
+#include <vector>
+
+namespace vkw {
+
+/**
+ * @class HostImageCopy
+ *
+ * copies texel data between host memory and images. When VK_EXT_host_image_copy
+ * is enabled together with its hostImageCopy feature and the image was
+ * created with VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT, copy is done by the host
+ * immediately without staging memory or device commands, provided the layout
+ * is one the device lists for host copies.
+ *
+ * Otherwise copy goes through a staging buffer: commands are recorded into
+ * provided recorder and staging buffer is returned. It must be kept alive
+ * until recorded commands complete.
+ *
+ * Data is tightly packed and covers whole mip level of given layers. Image
+ * must have a single aspect, depth/stencil images are not supported.
+ */
+class HostImageCopy {
+public:
+  explicit HostImageCopy(Device const &device) noexcept(ExceptionsDisabled)
+      : m_device(device) {
+#ifdef VK_EXT_host_image_copy
+    auto const &physicalDevice = device.physicalDevice();
+    if (!physicalDevice.isExtensionEnabled(ext::EXT_host_image_copy))
+      return;
+    auto const *features =
+        physicalDevice
+            .enabledFeatures<VkPhysicalDeviceHostImageCopyFeaturesEXT>(
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT);
+    if (!features || !features->hostImageCopy)
+      return;
+
+    VkPhysicalDeviceHostImageCopyPropertiesEXT properties{};
+    properties.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT;
+    if (!physicalDevice.queryProperties(properties))
+      return;
+    m_srcLayouts.resize(properties.copySrcLayoutCount);
+    m_dstLayouts.resize(properties.copyDstLayoutCount);
+    properties.pCopySrcLayouts = m_srcLayouts.data();
+    properties.pCopyDstLayouts = m_dstLayouts.data();
+    physicalDevice.queryProperties(properties);
+    m_srcLayouts.resize(properties.copySrcLayoutCount);
+    m_dstLayouts.resize(properties.copyDstLayoutCount);
+
+    m_extension.emplace(device);
+#endif
+  }
+
+  /**
+   * Whether copies of the image in layout are done by the host. layout is
+   * destination of copies from host or source of copies to host if toHost.
+   */
+  bool hostCopyAvailable(ImageInterface const &image, VkImageLayout layout,
+                         bool toHost = false) const noexcept {
+#ifdef VK_EXT_host_image_copy
+    auto const &layouts = toHost ? m_srcLayouts : m_dstLayouts;
+    return m_extension &&
+           (image.usage() & VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT) &&
+           std::ranges::find(layouts, layout) != layouts.end();
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * Writes data to mip level of the image. Contents of the level are
+   * discarded and on completion it is in dstLayout. Staging path makes
+   * result visible to dstStage/dstAccess.
+   */
+  std::optional<StagingBuffer<unsigned char>> copyFromHost(
+      TransferPassRecorder &recorder, DeviceAllocator &allocator,
+      AllocatedImage const &image, std::span<const unsigned char> data,
+      VkImageLayout dstLayout, uint32_t mipLevel = 0, uint32_t baseLayer = 0,
+      uint32_t layerCount = 1,
+      VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+      VkAccessFlags dstAccess =
+          VK_ACCESS_SHADER_READ_BIT) const noexcept(ExceptionsDisabled) {
+    auto subresource = m_subresource(image, mipLevel, baseLayer, layerCount);
+    auto extent = m_extent(image, mipLevel);
+    assert(data.size() >= formatDataSize(image.format(), extent) * layerCount &&
+           "not enough data to fill image level");
+
+#ifdef VK_EXT_host_image_copy
+    if (hostCopyAvailable(image, dstLayout)) {
+      m_transition(image, subresource, VK_IMAGE_LAYOUT_UNDEFINED, dstLayout);
+
+      VkMemoryToImageCopyEXT region{};
+      region.sType = VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT;
+      region.pHostPointer = data.data();
+      region.imageSubresource = subresource;
+      region.imageExtent = extent;
+
+      VkCopyMemoryToImageInfoEXT copyInfo{};
+      copyInfo.sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT;
+      copyInfo.dstImage = image;
+      copyInfo.dstImageLayout = dstLayout;
+      copyInfo.regionCount = 1;
+      copyInfo.pRegions = &region;
+      VK_CHECK_RESULT(
+          m_extension->vkCopyMemoryToImageEXT(m_device.get(), &copyInfo));
+      return std::nullopt;
+    }
+#endif
+
+    StagingBuffer<unsigned char> staging{allocator, data};
+    staging.flush();
+
+    auto barrier = m_barrier(image, subresource);
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT, {&barrier, 1});
+
+    VkBufferImageCopy region{};
+    region.imageSubresource = subresource;
+    region.imageExtent = extent;
+    recorder.copyBufferToImage(staging, image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               {&region, 1});
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = dstLayout;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = dstAccess;
+    recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage,
+                                {&barrier, 1});
+
+    return staging;
+  }
+
+  /**
+   * Reads mip level of the image which is in layout. Host path writes into
+   * data immediately. Staging path records copy into the returned buffer
+   * which can be read once recorded commands complete, data is left
+   * untouched then. Image is returned to layout in both cases.
+   */
+  std::optional<StagingBuffer<unsigned char>> copyToHost(
+      TransferPassRecorder &recorder, DeviceAllocator &allocator,
+      AllocatedImage const &image, VkImageLayout layout,
+      std::span<unsigned char> data, uint32_t mipLevel = 0,
+      uint32_t baseLayer = 0, uint32_t layerCount = 1,
+      VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+      VkAccessFlags srcAccess =
+          VK_ACCESS_MEMORY_WRITE_BIT) const noexcept(ExceptionsDisabled) {
+    auto subresource = m_subresource(image, mipLevel, baseLayer, layerCount);
+    auto extent = m_extent(image, mipLevel);
+    auto size = formatDataSize(image.format(), extent) * layerCount;
+
+#ifdef VK_EXT_host_image_copy
+    if (hostCopyAvailable(image, layout, /* toHost */ true)) {
+      assert(data.size() >= size && "not enough space for image level");
+
+      VkImageToMemoryCopyEXT region{};
+      region.sType = VK_STRUCTURE_TYPE_IMAGE_TO_MEMORY_COPY_EXT;
+      region.pHostPointer = data.data();
+      region.imageSubresource = subresource;
+      region.imageExtent = extent;
+
+      VkCopyImageToMemoryInfoEXT copyInfo{};
+      copyInfo.sType = VK_STRUCTURE_TYPE_COPY_IMAGE_TO_MEMORY_INFO_EXT;
+      copyInfo.srcImage = image;
+      copyInfo.srcImageLayout = layout;
+      copyInfo.regionCount = 1;
+      copyInfo.pRegions = &region;
+      VK_CHECK_RESULT(
+          m_extension->vkCopyImageToMemoryEXT(m_device.get(), &copyInfo));
+      return std::nullopt;
+    }
+#endif
+
+    StagingBuffer<unsigned char> staging{allocator, size};
+
+    auto barrier = m_barrier(image, subresource);
+    barrier.oldLayout = layout;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    recorder.imageMemoryBarrier(srcStage, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                {&barrier, 1});
+
+    VkBufferImageCopy region{};
+    region.imageSubresource = subresource;
+    region.imageExtent = extent;
+    recorder.copyImageToBuffer(image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               staging, {&region, 1});
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = layout;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = 0;
+    recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                {&barrier, 1});
+
+    VkBufferMemoryBarrier hostBarrier{};
+    hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.buffer = staging;
+    hostBarrier.offset = 0;
+    hostBarrier.size = VK_WHOLE_SIZE;
+    recorder.bufferMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_HOST_BIT,
+                                 {&hostBarrier, 1});
+
+    return staging;
+  }
+
+private:
+  static VkImageSubresourceLayers m_subresource(ImageInterface const &image,
+                                                uint32_t mipLevel,
+                                                uint32_t baseLayer,
+                                                uint32_t layerCount) noexcept {
+    VkImageSubresourceLayers ret{};
+    ret.aspectMask = image.completeSubresourceRange().aspectMask;
+    assert(std::has_single_bit(ret.aspectMask) &&
+           "copy region must address a single image aspect");
+    ret.mipLevel = mipLevel;
+    ret.baseArrayLayer = baseLayer;
+    ret.layerCount = layerCount;
+    return ret;
+  }
+
+  static VkExtent3D m_extent(ImageInterface const &image,
+                             uint32_t mipLevel) noexcept {
+    auto extent = image.rawExtents();
+    return VkExtent3D{std::max(1u, extent.width >> mipLevel),
+                      std::max(1u, extent.height >> mipLevel),
+                      std::max(1u, extent.depth >> mipLevel)};
+  }
+
+  static VkImageMemoryBarrier
+  m_barrier(ImageInterface const &image,
+            VkImageSubresourceLayers const &subresource) noexcept {
+    VkImageMemoryBarrier ret{};
+    ret.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    ret.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    ret.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    ret.image = image;
+    ret.subresourceRange.aspectMask = subresource.aspectMask;
+    ret.subresourceRange.baseMipLevel = subresource.mipLevel;
+    ret.subresourceRange.levelCount = 1;
+    ret.subresourceRange.baseArrayLayer = subresource.baseArrayLayer;
+    ret.subresourceRange.layerCount = subresource.layerCount;
+    return ret;
+  }
+
+#ifdef VK_EXT_host_image_copy
+  void m_transition(ImageInterface const &image,
+                    VkImageSubresourceLayers const &subresource,
+                    VkImageLayout oldLayout, VkImageLayout newLayout) const
+      noexcept(ExceptionsDisabled) {
+    VkHostImageLayoutTransitionInfoEXT transition{};
+    transition.sType = VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT;
+    transition.image = image;
+    transition.oldLayout = oldLayout;
+    transition.newLayout = newLayout;
+    transition.subresourceRange =
+        m_barrier(image, subresource).subresourceRange;
+    VK_CHECK_RESULT(m_extension->vkTransitionImageLayoutEXT(m_device.get(), 1,
+                                                            &transition));
+  }
+
+  std::optional<Extension<ext::EXT_host_image_copy>> m_extension;
+  std::vector<VkImageLayout> m_srcLayouts;
+  std::vector<VkImageLayout> m_dstLayouts;
+#endif
+  StrongReference<Device const> m_device;
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_HOSTIMAGECOPY_HPP
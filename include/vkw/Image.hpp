@@ -2,6 +2,7 @@
 #define VKRENDERER_IMAGE_HPP
 
 #include <vkw/Allocation.hpp>
+#include <vkw/Format.hpp>
 
 namespace vkw {
 
@@ -25,6 +26,8 @@ public:
 
   uint32_t mipLevels() const noexcept { return m_createInfo.mipLevels; }
 
+  VkImageTiling tiling() const noexcept { return m_createInfo.tiling; }
+
   VkImageSubresourceRange completeSubresourceRange() const noexcept {
     VkImageSubresourceRange ret{};
     ret.baseMipLevel = 0;
@@ -39,18 +42,7 @@ public:
   virtual operator VkImage() const noexcept = 0;
 
   static bool isDepthFormat(VkFormat format) noexcept {
-    switch (format) {
-    case VK_FORMAT_D16_UNORM:
-    case VK_FORMAT_D16_UNORM_S8_UINT:
-    case VK_FORMAT_X8_D24_UNORM_PACK32:
-    case VK_FORMAT_D24_UNORM_S8_UINT:
-    case VK_FORMAT_D32_SFLOAT_S8_UINT:
-    case VK_FORMAT_D32_SFLOAT:
-    case VK_FORMAT_S8_UINT:
-      return true;
-    default:
-      return false;
-    }
+    return formatInfo(format).isDepthStencil();
   }
 
   static bool isColorFormat(VkFormat format) noexcept {
@@ -94,6 +86,10 @@ public:
 
   VkFormat format() const noexcept { return m_createInfo.format; };
 
+  VkImageSubresourceRange const &subresourceRange() const noexcept {
+    return m_createInfo.subresourceRange;
+  }
+
 protected:
   explicit ImageViewBase(ImageInterface const *image = nullptr,
                          VkFormat format = VK_FORMAT_MAX_ENUM,
@@ -349,314 +345,19 @@ public:
 protected:
   ImageIPT(VkFormat format) noexcept { m_createInfo.format = format; }
 };
-namespace __detail {
-
-inline unsigned m_FormatRedBits(VkFormat format) noexcept {
-  switch (format) {
-  case VK_FORMAT_R8G8B8A8_UINT:
-  case VK_FORMAT_R8G8B8A8_SNORM:
-  case VK_FORMAT_R8G8B8A8_SSCALED:
-  case VK_FORMAT_R8G8B8A8_UNORM:
-  case VK_FORMAT_R8G8B8A8_SINT:
-  case VK_FORMAT_R8G8B8A8_USCALED:
-  case VK_FORMAT_R8G8B8A8_SRGB:
-  case VK_FORMAT_R8G8B8_SINT:
-  case VK_FORMAT_R8G8B8_SNORM:
-  case VK_FORMAT_R8G8B8_SRGB:
-  case VK_FORMAT_R8G8B8_UINT:
-  case VK_FORMAT_R8G8B8_USCALED:
-  case VK_FORMAT_R8G8B8_UNORM:
-  case VK_FORMAT_R8G8B8_SSCALED:
-  case VK_FORMAT_R8G8_SINT:
-  case VK_FORMAT_R8G8_SNORM:
-  case VK_FORMAT_R8G8_SRGB:
-  case VK_FORMAT_R8G8_UINT:
-  case VK_FORMAT_R8G8_USCALED:
-  case VK_FORMAT_R8G8_UNORM:
-  case VK_FORMAT_R8G8_SSCALED:
-  case VK_FORMAT_R8_SINT:
-  case VK_FORMAT_R8_SNORM:
-  case VK_FORMAT_R8_SRGB:
-  case VK_FORMAT_R8_UINT:
-  case VK_FORMAT_R8_USCALED:
-  case VK_FORMAT_R8_UNORM:
-  case VK_FORMAT_R8_SSCALED:
-    return 8;
-  case VK_FORMAT_R16G16B16A16_UINT:
-  case VK_FORMAT_R16G16B16A16_SNORM:
-  case VK_FORMAT_R16G16B16A16_SSCALED:
-  case VK_FORMAT_R16G16B16A16_UNORM:
-  case VK_FORMAT_R16G16B16A16_SINT:
-  case VK_FORMAT_R16G16B16A16_USCALED:
-  case VK_FORMAT_R16G16B16_SINT:
-  case VK_FORMAT_R16G16B16_SNORM:
-  case VK_FORMAT_R16G16B16_UINT:
-  case VK_FORMAT_R16G16B16_USCALED:
-  case VK_FORMAT_R16G16B16_UNORM:
-  case VK_FORMAT_R16G16B16_SSCALED:
-  case VK_FORMAT_R16G16_SINT:
-  case VK_FORMAT_R16G16_SNORM:
-  case VK_FORMAT_R16G16_UINT:
-  case VK_FORMAT_R16G16_USCALED:
-  case VK_FORMAT_R16G16_UNORM:
-  case VK_FORMAT_R16G16_SSCALED:
-  case VK_FORMAT_R16_SINT:
-  case VK_FORMAT_R16_SNORM:
-  case VK_FORMAT_R16_UINT:
-  case VK_FORMAT_R16_USCALED:
-  case VK_FORMAT_R16_UNORM:
-  case VK_FORMAT_R16_SSCALED:
-    return 16;
-  case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
-    return 11;
-  default:
-    assert("Format Not Handled yet");
-  }
-  return 0;
-}
-inline unsigned m_FormatGreenBits(VkFormat format) noexcept {
-  switch (format) {
-  case VK_FORMAT_R8G8B8A8_UINT:
-  case VK_FORMAT_R8G8B8A8_SNORM:
-  case VK_FORMAT_R8G8B8A8_SSCALED:
-  case VK_FORMAT_R8G8B8A8_UNORM:
-  case VK_FORMAT_R8G8B8A8_SINT:
-  case VK_FORMAT_R8G8B8A8_USCALED:
-  case VK_FORMAT_R8G8B8A8_SRGB:
-  case VK_FORMAT_R8G8B8_SINT:
-  case VK_FORMAT_R8G8B8_SNORM:
-  case VK_FORMAT_R8G8B8_SRGB:
-  case VK_FORMAT_R8G8B8_UINT:
-  case VK_FORMAT_R8G8B8_USCALED:
-  case VK_FORMAT_R8G8B8_UNORM:
-  case VK_FORMAT_R8G8B8_SSCALED:
-  case VK_FORMAT_R8G8_SINT:
-  case VK_FORMAT_R8G8_SNORM:
-  case VK_FORMAT_R8G8_SRGB:
-  case VK_FORMAT_R8G8_UINT:
-  case VK_FORMAT_R8G8_USCALED:
-  case VK_FORMAT_R8G8_UNORM:
-  case VK_FORMAT_R8G8_SSCALED:
-    return 8;
-  case VK_FORMAT_R16G16B16A16_UINT:
-  case VK_FORMAT_R16G16B16A16_SNORM:
-  case VK_FORMAT_R16G16B16A16_SSCALED:
-  case VK_FORMAT_R16G16B16A16_UNORM:
-  case VK_FORMAT_R16G16B16A16_SINT:
-  case VK_FORMAT_R16G16B16A16_USCALED:
-  case VK_FORMAT_R16G16B16_SINT:
-  case VK_FORMAT_R16G16B16_SNORM:
-  case VK_FORMAT_R16G16B16_UINT:
-  case VK_FORMAT_R16G16B16_USCALED:
-  case VK_FORMAT_R16G16B16_UNORM:
-  case VK_FORMAT_R16G16B16_SSCALED:
-  case VK_FORMAT_R16G16_SINT:
-  case VK_FORMAT_R16G16_SNORM:
-  case VK_FORMAT_R16G16_UINT:
-  case VK_FORMAT_R16G16_USCALED:
-  case VK_FORMAT_R16G16_UNORM:
-  case VK_FORMAT_R16G16_SSCALED:
-    return 16;
-  case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
-    return 11;
-  case VK_FORMAT_R8_SINT:
-  case VK_FORMAT_R8_SNORM:
-  case VK_FORMAT_R8_SRGB:
-  case VK_FORMAT_R8_UINT:
-  case VK_FORMAT_R8_USCALED:
-  case VK_FORMAT_R8_UNORM:
-  case VK_FORMAT_R8_SSCALED:
-  case VK_FORMAT_R16_SINT:
-  case VK_FORMAT_R16_SNORM:
-  case VK_FORMAT_R16_UINT:
-  case VK_FORMAT_R16_USCALED:
-  case VK_FORMAT_R16_UNORM:
-  case VK_FORMAT_R16_SSCALED:
-    return 0;
-
-  default:
-    assert("Format Not Handled yet");
-  }
-  return 0;
-}
-inline unsigned m_FormatBlueBits(VkFormat format) noexcept {
-  switch (format) {
-  case VK_FORMAT_R8G8B8A8_UINT:
-  case VK_FORMAT_R8G8B8A8_SNORM:
-  case VK_FORMAT_R8G8B8A8_SSCALED:
-  case VK_FORMAT_R8G8B8A8_UNORM:
-  case VK_FORMAT_R8G8B8A8_SINT:
-  case VK_FORMAT_R8G8B8A8_USCALED:
-  case VK_FORMAT_R8G8B8A8_SRGB:
-  case VK_FORMAT_R8G8B8_SINT:
-  case VK_FORMAT_R8G8B8_SNORM:
-  case VK_FORMAT_R8G8B8_SRGB:
-  case VK_FORMAT_R8G8B8_UINT:
-  case VK_FORMAT_R8G8B8_USCALED:
-  case VK_FORMAT_R8G8B8_UNORM:
-  case VK_FORMAT_R8G8B8_SSCALED:
-    return 8;
-
-  case VK_FORMAT_R8_SSCALED:
-  case VK_FORMAT_R16G16B16A16_UINT:
-  case VK_FORMAT_R16G16B16A16_SNORM:
-  case VK_FORMAT_R16G16B16A16_SSCALED:
-  case VK_FORMAT_R16G16B16A16_UNORM:
-  case VK_FORMAT_R16G16B16A16_SINT:
-  case VK_FORMAT_R16G16B16A16_USCALED:
-  case VK_FORMAT_R16G16B16_SINT:
-  case VK_FORMAT_R16G16B16_SNORM:
-  case VK_FORMAT_R16G16B16_UINT:
-  case VK_FORMAT_R16G16B16_USCALED:
-  case VK_FORMAT_R16G16B16_UNORM:
-  case VK_FORMAT_R16G16B16_SSCALED:
-    return 16;
-  case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
-    return 10;
-  case VK_FORMAT_R8G8_SINT:
-  case VK_FORMAT_R8G8_SNORM:
-  case VK_FORMAT_R8G8_SRGB:
-  case VK_FORMAT_R8G8_UINT:
-  case VK_FORMAT_R8G8_USCALED:
-  case VK_FORMAT_R8G8_UNORM:
-  case VK_FORMAT_R8G8_SSCALED:
-  case VK_FORMAT_R8_SINT:
-  case VK_FORMAT_R8_SNORM:
-  case VK_FORMAT_R8_SRGB:
-  case VK_FORMAT_R8_UINT:
-  case VK_FORMAT_R8_USCALED:
-  case VK_FORMAT_R8_UNORM:
-  case VK_FORMAT_R16G16_SINT:
-  case VK_FORMAT_R16G16_SNORM:
-  case VK_FORMAT_R16G16_UINT:
-  case VK_FORMAT_R16G16_USCALED:
-  case VK_FORMAT_R16G16_UNORM:
-  case VK_FORMAT_R16G16_SSCALED:
-  case VK_FORMAT_R16_SINT:
-  case VK_FORMAT_R16_SNORM:
-  case VK_FORMAT_R16_UINT:
-  case VK_FORMAT_R16_USCALED:
-  case VK_FORMAT_R16_UNORM:
-  case VK_FORMAT_R16_SSCALED:
-    return 0;
-  default:
-    assert("Format Not Handled yet");
-  }
-  return 0;
-}
-inline unsigned m_FormatAlphaBits(VkFormat format) noexcept {
-  switch (format) {
-  case VK_FORMAT_R8G8B8A8_UINT:
-  case VK_FORMAT_R8G8B8A8_SNORM:
-  case VK_FORMAT_R8G8B8A8_SSCALED:
-  case VK_FORMAT_R8G8B8A8_UNORM:
-  case VK_FORMAT_R8G8B8A8_SINT:
-  case VK_FORMAT_R8G8B8A8_USCALED:
-  case VK_FORMAT_R8G8B8A8_SRGB:
-    return 8;
-  case VK_FORMAT_R16G16B16A16_UINT:
-  case VK_FORMAT_R16G16B16A16_SNORM:
-  case VK_FORMAT_R16G16B16A16_SSCALED:
-  case VK_FORMAT_R16G16B16A16_UNORM:
-  case VK_FORMAT_R16G16B16A16_SINT:
-  case VK_FORMAT_R16G16B16A16_USCALED:
-    return 16;
-  case VK_FORMAT_R8G8B8_SINT:
-  case VK_FORMAT_R8G8B8_SNORM:
-  case VK_FORMAT_R8G8B8_SRGB:
-  case VK_FORMAT_R8G8B8_UINT:
-  case VK_FORMAT_R8G8B8_USCALED:
-  case VK_FORMAT_R8G8B8_UNORM:
-  case VK_FORMAT_R8G8B8_SSCALED:
-  case VK_FORMAT_R8G8_SINT:
-  case VK_FORMAT_R8G8_SNORM:
-  case VK_FORMAT_R8G8_SRGB:
-  case VK_FORMAT_R8G8_UINT:
-  case VK_FORMAT_R8G8_USCALED:
-  case VK_FORMAT_R8G8_UNORM:
-  case VK_FORMAT_R8G8_SSCALED:
-  case VK_FORMAT_R8_SINT:
-  case VK_FORMAT_R8_SNORM:
-  case VK_FORMAT_R8_SRGB:
-  case VK_FORMAT_R8_UINT:
-  case VK_FORMAT_R8_USCALED:
-  case VK_FORMAT_R8_UNORM:
-  case VK_FORMAT_R8_SSCALED:
-  case VK_FORMAT_R16G16B16_SINT:
-  case VK_FORMAT_R16G16B16_SNORM:
-  case VK_FORMAT_R16G16B16_UINT:
-  case VK_FORMAT_R16G16B16_USCALED:
-  case VK_FORMAT_R16G16B16_UNORM:
-  case VK_FORMAT_R16G16B16_SSCALED:
-  case VK_FORMAT_R16G16_SINT:
-  case VK_FORMAT_R16G16_SNORM:
-  case VK_FORMAT_R16G16_UINT:
-  case VK_FORMAT_R16G16_USCALED:
-  case VK_FORMAT_R16G16_UNORM:
-  case VK_FORMAT_R16G16_SSCALED:
-  case VK_FORMAT_R16_SINT:
-  case VK_FORMAT_R16_SNORM:
-  case VK_FORMAT_R16_UINT:
-  case VK_FORMAT_R16_USCALED:
-  case VK_FORMAT_R16_UNORM:
-  case VK_FORMAT_R16_SSCALED:
-  case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
-    return 0;
-  default:
-    assert("Format Not Handled yet");
-  }
-  return 0;
-}
-inline unsigned m_FormatDepthBits(VkFormat format) noexcept {
-  switch (format) {
-  case VK_FORMAT_D16_UNORM:
-  case VK_FORMAT_D16_UNORM_S8_UINT:
-    return 16;
-  case VK_FORMAT_X8_D24_UNORM_PACK32:
-  case VK_FORMAT_D24_UNORM_S8_UINT:
-    return 24;
-  case VK_FORMAT_D32_SFLOAT_S8_UINT:
-  case VK_FORMAT_D32_SFLOAT:
-    return 32;
-  case VK_FORMAT_S8_UINT:
-    return 0;
-  default:
-    assert("Format Not Handled yet");
-  }
-  return 0;
-}
-inline unsigned m_FormatStencilBits(VkFormat format) noexcept {
-  switch (format) {
-
-  case VK_FORMAT_D16_UNORM_S8_UINT:
-  case VK_FORMAT_S8_UINT:
-  case VK_FORMAT_D24_UNORM_S8_UINT:
-  case VK_FORMAT_D32_SFLOAT_S8_UINT:
-    return 8;
-  case VK_FORMAT_X8_D24_UNORM_PACK32:
-  case VK_FORMAT_D16_UNORM:
-  case VK_FORMAT_D32_SFLOAT:
-    return 0;
-  default:
-    assert("Format Not Handled yet");
-  }
-  return 0;
-}
-
-} // namespace __detail
 template <> class ImageIPT<COLOR> : virtual public ImageInterface {
 public:
   unsigned redBits() const noexcept {
-    return __detail::m_FormatRedBits(m_createInfo.format);
+    return formatInfo(m_createInfo.format).redBits;
   }
   unsigned greenBits() const noexcept {
-    return __detail::m_FormatGreenBits(m_createInfo.format);
+    return formatInfo(m_createInfo.format).greenBits;
   }
   unsigned blueBits() const noexcept {
-    return __detail::m_FormatBlueBits(m_createInfo.format);
+    return formatInfo(m_createInfo.format).blueBits;
   }
   unsigned alphaBits() const noexcept {
-    return __detail::m_FormatAlphaBits(m_createInfo.format);
+    return formatInfo(m_createInfo.format).alphaBits;
   }
 
 protected:
@@ -666,7 +367,7 @@ protected:
 template <> class ImageIPT<DEPTH> : virtual public ImageInterface {
 public:
   unsigned dBits() const noexcept {
-    return __detail::m_FormatDepthBits(m_createInfo.format);
+    return formatInfo(m_createInfo.format).depthBits;
   }
 
 protected:
@@ -676,10 +377,10 @@ protected:
 template <> class ImageIPT<DEPTH_STENCIL> : virtual public ImageInterface {
 public:
   unsigned dBits() const noexcept {
-    return __detail::m_FormatDepthBits(m_createInfo.format);
+    return formatInfo(m_createInfo.format).depthBits;
   }
   unsigned sBits() const noexcept {
-    return __detail::m_FormatStencilBits(m_createInfo.format);
+    return formatInfo(m_createInfo.format).stencilBits;
   }
 
 protected:
@@ -898,5 +599,71 @@ public:
         AllocatedImage(allocator, allocCreateInfo) {}
 };
 
+template <ImagePixelType ptype> struct ImageAttachmentUsageVal {};
+
+template <> struct ImageAttachmentUsageVal<COLOR> {
+  static constexpr const VkImageUsageFlags value =
+      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+};
+
+template <> struct ImageAttachmentUsageVal<DEPTH> {
+  static constexpr const VkImageUsageFlags value =
+      VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+};
+
+template <> struct ImageAttachmentUsageVal<DEPTH_STENCIL> {
+  static constexpr const VkImageUsageFlags value =
+      VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+};
+
+/**
+ *                         Transient Attachment
+ *     This class represents attachment which contents live only within a
+ *     render pass (depth buffers, multisampled color resolved at the end of
+ *     the pass). On tiled GPUs such images may stay in tile memory entirely,
+ *     so lazily allocated memory is preferred. If no lazily allocated type
+ *     suits the image (e.g. for its format or sample count), ordinary device
+ *     local memory is allocated.
+ *
+ *     Only input attachment usage may be added on top of attachment usage.
+ */
+template <ImagePixelType ptype, ImageArrayness iarr = SINGLE>
+class TransientAttachment : public BasicImage<ptype, I2D, iarr>,
+                            public ImageRestInterface,
+                            public AllocatedImage {
+public:
+  TransientAttachment(
+      DeviceAllocator &allocator, VkFormat format, uint32_t width,
+      uint32_t height, VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+      uint32_t layers = 1, VkImageUsageFlags usage = 0,
+      SharingInfo const &sharingInfo = {}) noexcept(ExceptionsDisabled)
+      : BasicImage<ptype, I2D, iarr>(format, width, height, 1, layers),
+        ImageRestInterface(samples, 1,
+                           usage | ImageAttachmentUsageVal<ptype>::value |
+                               VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+                           0, VK_IMAGE_LAYOUT_UNDEFINED,
+                           VK_IMAGE_TILING_OPTIMAL, sharingInfo),
+        AllocatedImage(allocator, m_allocationInfo()) {
+    assert((usage & ~(ImageAttachmentUsageVal<ptype>::value |
+                      VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                      VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)) == 0 &&
+           "only input attachment usage may be added to transient image");
+  }
+
+  /// Whether image is backed by lazily allocated memory.
+  bool lazilyAllocated() const noexcept {
+    return memoryProperties() & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+  }
+
+private:
+  // Lazy memory is only preferred: VMA picks memory type among ones allowed
+  // by image memory requirements and falls back to device local memory.
+  static AllocationCreateInfo m_allocationInfo() noexcept {
+    return AllocationCreateInfo{
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        .preferredFlags = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT};
+  }
+};
+
 } // namespace vkw
 #endif // VKRENDERER_IMAGE_HPP
@@ -141,6 +141,7 @@ private:
 template <> struct VulkanTypeTraits<VkInstance> {
   using CreatorType = vkw::Library;
   using CreateInfoType = CompiledInstanceCreateInfo;
+  static constexpr VkObjectType objectType = VK_OBJECT_TYPE_INSTANCE;
 };
 
 template <> struct VulkanTypeDeleter<VkInstance> {
@@ -0,0 +1,314 @@
+#ifndef VKWRAPPER_KTX2_HPP
+#define VKWRAPPER_KTX2_HPP
+
+#include <vkw/CommandRecorder.hpp>
+#include <vkw/Format.hpp>
+#include <vkw/Image.hpp>
+#include <vkw/MappedFile.hpp>
+#include <vkw/StagingBuffer.hpp>
+
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <optional>
+
+namespace vkw {
+
+class KTX2Error final : public Error {
+public:
+  KTX2Error(std::string_view what) noexcept : Error(what) {}
+
+  std::string_view codeString() const noexcept override {
+    return "KTX2 error";
+  }
+};
+
+/** Supercompression scheme of KTX2 level data. */
+enum class KTX2Supercompression : uint32_t {
+  NONE = 0,
+  BASIS_LZ = 1,
+  ZSTANDARD = 2,
+  ZLIB = 3
+};
+
+struct KTX2LevelInfo {
+  uint64_t byteOffset;
+  uint64_t byteLength;
+  uint64_t uncompressedByteLength;
+};
+
+namespace __detail {
+
+inline constexpr unsigned char m_ktx2Identifier[12] = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+inline constexpr size_t m_ktx2HeaderSize = 80;
+inline constexpr size_t m_ktx2LevelIndexEntrySize = 24;
+
+// KTX2 is little endian as well as every platform vkw is built for.
+template <typename T>
+T m_ktx2Read(std::span<const unsigned char> data, size_t offset) noexcept {
+  T ret;
+  std::memcpy(&ret, data.data() + offset, sizeof(T));
+  return ret;
+}
+
+} // namespace __detail
+
+/**
+ * @class KTX2Texture
+ *
+ * is a parsed KTX2 container. Level data is never copied out of the source:
+ * when texture is opened from a path the file is mapped and level data is
+ * written straight from the mapping into staging memory on upload.
+ *
+ * Only textures that carry a VkFormat can be uploaded. Supercompressed level
+ * data is handed to a caller provided decompressor which writes its output
+ * directly into staging memory.
+ */
+class KTX2Texture {
+public:
+  using Decompressor =
+      std::function<void(KTX2Supercompression scheme,
+                         std::span<const unsigned char> src,
+                         std::span<unsigned char> dst)>;
+
+  /// Parses texture from memory. Data must outlive the texture.
+  explicit KTX2Texture(std::span<const unsigned char> data) noexcept(
+      ExceptionsDisabled)
+      : m_data(data) {
+    m_parse();
+  }
+
+  explicit KTX2Texture(std::string const &path) noexcept(ExceptionsDisabled)
+      : m_file(std::in_place, path), m_data(m_file->data()) {
+    m_parse();
+  }
+
+  KTX2Texture(KTX2Texture const &another) = delete;
+  KTX2Texture &operator=(KTX2Texture const &another) = delete;
+
+  VkFormat format() const noexcept { return m_format; }
+
+  VkExtent3D extents() const noexcept { return m_extent; }
+
+  /// Extents of mip level.
+  VkExtent3D extents(uint32_t level) const noexcept {
+    return VkExtent3D{std::max(1u, m_extent.width >> level),
+                      std::max(1u, m_extent.height >> level),
+                      std::max(1u, m_extent.depth >> level)};
+  }
+
+  uint32_t layerCount() const noexcept { return m_layerCount; }
+
+  uint32_t faceCount() const noexcept { return m_faceCount; }
+
+  uint32_t levelCount() const noexcept { return m_levels.size(); }
+
+  KTX2Supercompression supercompression() const noexcept {
+    return m_supercompression;
+  }
+
+  KTX2LevelInfo const &level(uint32_t index) const noexcept {
+    return m_levels.at(index);
+  }
+
+  /// Level data as stored in container (possibly supercompressed).
+  std::span<const unsigned char> levelData(uint32_t index) const noexcept {
+    auto const &info = m_levels.at(index);
+    return m_data.subspan(info.byteOffset, info.byteLength);
+  }
+
+  std::span<const unsigned char> dataFormatDescriptor() const noexcept {
+    return m_dfd;
+  }
+
+  std::span<const unsigned char> keyValueData() const noexcept {
+    return m_kvd;
+  }
+
+  std::span<const unsigned char> supercompressionGlobalData() const noexcept {
+    return m_sgd;
+  }
+
+  /**
+   * Creates image able to hold every level of the texture. Levels are meant
+   * to be filled with uploadLevels().
+   */
+  Image<COLOR, I2D>
+  createImage(DeviceAllocator &allocator,
+              AllocationCreateInfo const &allocCreateInfo,
+              VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT) const
+      noexcept(ExceptionsDisabled) {
+    if (m_format == VK_FORMAT_UNDEFINED)
+      postError(KTX2Error("Texture has no VkFormat and must be transcoded"));
+    if (m_layerCount > 1 || m_faceCount > 1 || m_extent.depth > 1)
+      postError(KTX2Error("Only single layer 2D textures are supported"));
+
+    return Image<COLOR, I2D>(allocator, allocCreateInfo, m_format,
+                             m_extent.width, m_extent.height, 1, 1,
+                             levelCount(),
+                             usage | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+  }
+
+  /**
+   * Records upload of as many not yet resident levels as fit into the ring.
+   *
+   * Levels [firstResidentLevel, levelCount()) are considered already
+   * uploaded. Levels are uploaded from the smallest one towards level 0, so
+   * texture becomes usable at low resolution as soon as possible. All
+   * uploaded levels are copied with a single command and transitioned to
+   * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+   *
+   * Ring space is consumed up to ring.head() and must be released by caller
+   * once recorded commands complete.
+   *
+   * @return new first resident level.
+   */
+  uint32_t uploadLevels(
+      TransferPassRecorder &recorder, StagingRing &ring,
+      AllocatedImage const &image, uint32_t firstResidentLevel,
+      Decompressor const &decompressor = {},
+      VkPipelineStageFlags dstStage =
+          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT) const
+      noexcept(ExceptionsDisabled) {
+    if (m_supercompression != KTX2Supercompression::NONE && !decompressor)
+      postError(KTX2Error("Supercompressed texture requires decompressor"));
+
+    auto const &info = formatInfo(m_format);
+    auto blockSize = std::max<VkDeviceSize>(info.blockSize, 1);
+    auto alignment = std::lcm(VkDeviceSize(4), blockSize);
+
+    cntr::vector<VkBufferImageCopy, 16> regions;
+    auto level = std::min(firstResidentLevel, levelCount());
+    while (level > 0) {
+      auto const &levelInfo = m_levels.at(level - 1);
+      auto size = m_supercompression == KTX2Supercompression::NONE
+                      ? levelInfo.byteLength
+                      : levelInfo.uncompressedByteLength;
+      if (size != formatDataSize(m_format, extents(level - 1)))
+        postError(KTX2Error("Level size does not match texture format"));
+      if (size > ring.capacity())
+        postError(KTX2Error("Level does not fit into staging ring"));
+
+      auto region = ring.allocate(size, alignment);
+      if (!region)
+        break;
+
+      auto src = levelData(level - 1);
+      if (m_supercompression == KTX2Supercompression::NONE)
+        std::memcpy(region->data.data(), src.data(), src.size());
+      else
+        decompressor(m_supercompression, src, region->data);
+      ring.flush(*region);
+
+      --level;
+
+      VkBufferImageCopy copy{};
+      copy.bufferOffset = region->offset;
+      copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      copy.imageSubresource.mipLevel = level;
+      copy.imageSubresource.baseArrayLayer = 0;
+      copy.imageSubresource.layerCount = 1;
+      copy.imageExtent = extents(level);
+      regions.push_back(copy);
+    }
+
+    if (regions.empty())
+      return firstResidentLevel;
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = level;
+    barrier.subresourceRange.levelCount = regions.size();
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT, {&barrier, 1});
+
+    recorder.copyBufferToImage(ring.buffer(), image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions);
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage,
+                                {&barrier, 1});
+
+    return level;
+  }
+
+private:
+  void m_parse() noexcept(ExceptionsDisabled) {
+    using namespace __detail;
+    if (m_data.size() < m_ktx2HeaderSize ||
+        !std::equal(std::begin(m_ktx2Identifier), std::end(m_ktx2Identifier),
+                    m_data.begin()))
+      postError(KTX2Error("Data is not a KTX2 container"));
+
+    m_format = static_cast<VkFormat>(m_ktx2Read<uint32_t>(m_data, 12));
+    m_extent.width = m_ktx2Read<uint32_t>(m_data, 20);
+    m_extent.height = std::max(1u, m_ktx2Read<uint32_t>(m_data, 24));
+    m_extent.depth = std::max(1u, m_ktx2Read<uint32_t>(m_data, 28));
+    m_layerCount = std::max(1u, m_ktx2Read<uint32_t>(m_data, 32));
+    m_faceCount = std::max(1u, m_ktx2Read<uint32_t>(m_data, 36));
+    // Level count of 0 asks loader to generate mip chain, only level 0 is
+    // present in the container then.
+    auto levelCount = std::max(1u, m_ktx2Read<uint32_t>(m_data, 40));
+    m_supercompression =
+        static_cast<KTX2Supercompression>(m_ktx2Read<uint32_t>(m_data, 44));
+
+    m_dfd = m_section(m_ktx2Read<uint32_t>(m_data, 48),
+                      m_ktx2Read<uint32_t>(m_data, 52));
+    m_kvd = m_section(m_ktx2Read<uint32_t>(m_data, 56),
+                      m_ktx2Read<uint32_t>(m_data, 60));
+    m_sgd = m_section(m_ktx2Read<uint64_t>(m_data, 64),
+                      m_ktx2Read<uint64_t>(m_data, 72));
+
+    auto index = m_section(m_ktx2HeaderSize,
+                           uint64_t(levelCount) * m_ktx2LevelIndexEntrySize);
+    m_levels.reserve(levelCount);
+    for (uint32_t i = 0; i < levelCount; ++i) {
+      auto offset = i * m_ktx2LevelIndexEntrySize;
+      KTX2LevelInfo info{m_ktx2Read<uint64_t>(index, offset),
+                         m_ktx2Read<uint64_t>(index, offset + 8),
+                         m_ktx2Read<uint64_t>(index, offset + 16)};
+      m_section(info.byteOffset, info.byteLength);
+      m_levels.push_back(info);
+    }
+  }
+
+  std::span<const unsigned char> m_section(uint64_t offset,
+                                           uint64_t length) const
+      noexcept(ExceptionsDisabled) {
+    if (offset > m_data.size() || length > m_data.size() - offset)
+      postError(KTX2Error("Section exceeds container size"));
+    return m_data.subspan(offset, length);
+  }
+
+  std::optional<MappedFile> m_file;
+  std::span<const unsigned char> m_data;
+  VkFormat m_format = VK_FORMAT_UNDEFINED;
+  VkExtent3D m_extent{};
+  uint32_t m_layerCount = 1;
+  uint32_t m_faceCount = 1;
+  KTX2Supercompression m_supercompression = KTX2Supercompression::NONE;
+  std::span<const unsigned char> m_dfd;
+  std::span<const unsigned char> m_kvd;
+  std::span<const unsigned char> m_sgd;
+  std::vector<KTX2LevelInfo> m_levels;
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_KTX2_HPP
@@ -0,0 +1,54 @@
+#ifndef VKWRAPPER_MAPPEDFILE_HPP
+#define VKWRAPPER_MAPPEDFILE_HPP
+
+#include <vkw/Exception.hpp>
+#include <vkw/Runtime.h>
+
+#include <memory>
+#include <span>
+#include <string>
+
+namespace vkw {
+
+class FileMapError final : public Error {
+public:
+  FileMapError(std::string_view what) noexcept : Error(what) {}
+
+  std::string_view codeString() const noexcept override {
+    return "File mapping failed";
+  }
+};
+
+/**
+ * @class MappedFile
+ *
+ * is a read-only view of a whole file mapped into the address space via
+ * vkwrt. Pages are read by the os on first access, so data can be copied
+ * straight into staging memory without intermediate buffers.
+ */
+class MappedFile {
+public:
+  explicit MappedFile(std::string const &path) noexcept(ExceptionsDisabled) {
+    VKW_MappedFile handle = nullptr;
+    const void *data = nullptr;
+    size_t size = 0;
+    if (vkw_mapFile(path.c_str(), &handle, &data, &size) != VKW_OK)
+      postError(FileMapError(vkw_lastError()));
+    m_handle.reset(handle);
+    m_data = {static_cast<const unsigned char *>(data), size};
+  }
+
+  std::span<const unsigned char> data() const noexcept { return m_data; }
+
+  size_t size() const noexcept { return m_data.size(); }
+
+private:
+  struct Unmapper {
+    void operator()(VKW_MappedFile handle) { vkw_unmapFile(handle); }
+  };
+  std::unique_ptr<VKW_MappedFile_T, Unmapper> m_handle;
+  std::span<const unsigned char> m_data;
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_MAPPEDFILE_HPP
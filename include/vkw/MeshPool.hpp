@@ -0,0 +1,219 @@
+#ifndef VKWRAPPER_MESHPOOL_HPP
+#define VKWRAPPER_MESHPOOL_HPP
+
+#include <vkw/CommandRecorder.hpp>
+#include <vkw/Upload.hpp>
+#include <vkw/VertexBuffer.hpp>
+
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace vkw {
+
+template <AttributeArray T, VkIndexType type> class MeshPool;
+
+/**
+ * @class PooledMesh
+ *
+ * location of mesh geometry inside of MeshPool. Indices are relative to
+ * vertexOffset, so firstIndex, vertexOffset and indexCount can be passed to
+ * drawIndexed() as they are.
+ */
+class PooledMesh {
+public:
+  uint32_t firstIndex = 0;
+  int32_t vertexOffset = 0;
+  uint32_t indexCount = 0;
+  uint32_t vertexCount = 0;
+
+  /// Draw parameters of this mesh.
+  VkDrawIndexedIndirectCommand
+  drawCommand(uint32_t instanceCount = 1,
+              uint32_t firstInstance = 0) const noexcept {
+    return {indexCount, instanceCount, firstIndex, vertexOffset,
+            firstInstance};
+  }
+
+private:
+  template <AttributeArray T, VkIndexType type> friend class MeshPool;
+
+  VmaVirtualAllocation m_vertexAllocation = VK_NULL_HANDLE;
+  VmaVirtualAllocation m_indexAllocation = VK_NULL_HANDLE;
+};
+
+namespace __detail {
+
+struct VirtualBlockDeleter {
+  void operator()(VmaVirtualBlock block) const noexcept {
+    vmaClearVirtualBlock(block);
+    vmaDestroyVirtualBlock(block);
+  }
+};
+
+using VirtualBlockPtr = std::unique_ptr<VmaVirtualBlock_T, VirtualBlockDeleter>;
+
+inline VirtualBlockPtr
+m_createVirtualBlock(VkDeviceSize size) noexcept(ExceptionsDisabled) {
+  VmaVirtualBlockCreateInfo createInfo{};
+  createInfo.size = size;
+  VmaVirtualBlock block = VK_NULL_HANDLE;
+  VK_CHECK_RESULT(vmaCreateVirtualBlock(&createInfo, &block));
+  return VirtualBlockPtr{block};
+}
+
+} // namespace __detail
+
+/**
+ * @class MeshPool
+ *
+ * owns one vertex buffer and one index buffer shared by many meshes. Ranges
+ * of both buffers are sub-allocated through VMA virtual blocks, counted in
+ * vertices and indices respectively.
+ *
+ * All meshes of the pool are drawn after a single bind() call, with
+ * drawIndexed() per mesh or with one drawIndexedIndirect() over commands
+ * produced by writeDrawCommands().
+ *
+ * Allocation and freeing are not thread safe.
+ */
+template <AttributeArray T, VkIndexType type> class MeshPool {
+public:
+  using IndexT = typename vkr_index_type<type>::Type;
+
+  /**
+   * Buffers are placed in memory chosen by allocInfo, by default device
+   * local memory that host writes directly when available (see Upload.hpp).
+   * TRANSFER_DST usage is always added.
+   */
+  MeshPool(DeviceAllocator &allocator, uint32_t vertexCapacity,
+           uint32_t indexCapacity,
+           AllocationCreateInfo const &allocInfo = directUploadAllocationInfo(),
+           VkBufferUsageFlags usage = 0) noexcept(ExceptionsDisabled)
+      : m_vertices(allocator, vertexCapacity, allocInfo,
+                   usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT),
+        m_indices(allocator, indexCapacity, allocInfo,
+                  usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT),
+        m_vertexBlock(__detail::m_createVirtualBlock(vertexCapacity)),
+        m_indexBlock(__detail::m_createVirtualBlock(indexCapacity)) {}
+
+  /**
+   * Reserves ranges for mesh with given vertex and index count. Returns
+   * nullopt if pool has no space left for it.
+   */
+  std::optional<PooledMesh> allocate(uint32_t vertexCount,
+                                     uint32_t indexCount) noexcept {
+    assert(vertexCount > 0 && indexCount > 0 && "mesh is empty");
+    PooledMesh mesh;
+    mesh.vertexCount = vertexCount;
+    mesh.indexCount = indexCount;
+
+    VmaVirtualAllocationCreateInfo allocInfo{};
+    VkDeviceSize offset = 0;
+    allocInfo.size = vertexCount;
+    if (vmaVirtualAllocate(m_vertexBlock.get(), &allocInfo,
+                           &mesh.m_vertexAllocation, &offset) != VK_SUCCESS)
+      return std::nullopt;
+    mesh.vertexOffset = static_cast<int32_t>(offset);
+
+    allocInfo.size = indexCount;
+    if (vmaVirtualAllocate(m_indexBlock.get(), &allocInfo,
+                           &mesh.m_indexAllocation, &offset) != VK_SUCCESS) {
+      vmaVirtualFree(m_vertexBlock.get(), mesh.m_vertexAllocation);
+      return std::nullopt;
+    }
+    mesh.firstIndex = static_cast<uint32_t>(offset);
+
+    return mesh;
+  }
+
+  /// Returns ranges of mesh to the pool. Mesh must not be used after this.
+  void free(PooledMesh const &mesh) noexcept {
+    vmaVirtualFree(m_vertexBlock.get(), mesh.m_vertexAllocation);
+    vmaVirtualFree(m_indexBlock.get(), mesh.m_indexAllocation);
+  }
+
+  /**
+   * Writes geometry of mesh. Indices are relative to the first vertex of
+   * the mesh. Returned staging buffers (if any) must be kept alive until
+   * recorded copies complete.
+   */
+  std::pair<UploadResult, UploadResult>
+  upload(TransferPassRecorder &recorder, DeviceAllocator &allocator,
+         PooledMesh const &mesh, std::span<const T> vertices,
+         std::span<const IndexT> indices) noexcept(ExceptionsDisabled) {
+    assert(vertices.size() <= mesh.vertexCount &&
+           indices.size() <= mesh.indexCount && "mesh data out of range");
+    auto bytes = []<typename U>(std::span<const U> data) {
+      return std::span<const unsigned char>{
+          reinterpret_cast<unsigned char const *>(data.data()),
+          data.size_bytes()};
+    };
+    return {vkw::upload(recorder, allocator, m_vertices,
+                        mesh.vertexOffset * sizeof(T), bytes(vertices),
+                        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                        VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT),
+            vkw::upload(recorder, allocator, m_indices,
+                        mesh.firstIndex * sizeof(IndexT), bytes(indices),
+                        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                        VK_ACCESS_INDEX_READ_BIT)};
+  }
+
+  /// Binds pool buffers, meshes are then drawn without rebinding.
+  void bind(RenderPassRecorder &recorder,
+            uint32_t binding = 0) const noexcept {
+    recorder.bindVertexBuffer(m_vertices, binding, 0);
+    recorder.bindIndexBuffer(m_indices, 0);
+  }
+
+  /**
+   * Writes draw commands of meshes into mapped indirect buffer starting from
+   * firstDraw and flushes them. firstInstance of draw i is i, so per draw
+   * data can be looked up by gl_InstanceIndex or instance rate attributes.
+   * Returns number of commands written.
+   */
+  static uint32_t writeDrawCommands(
+      std::span<const PooledMesh> meshes,
+      IndirectBuffer<VkDrawIndexedIndirectCommand> &buffer,
+      uint32_t firstDraw = 0) noexcept(ExceptionsDisabled) {
+    auto commands = buffer.mapped();
+    assert(!commands.empty() && "indirect buffer is not mapped");
+    assert(firstDraw + meshes.size() <= commands.size() &&
+           "indirect buffer is too small");
+    for (uint32_t i = 0; i < meshes.size(); ++i)
+      commands[firstDraw + i] = meshes[i].drawCommand(1, i);
+    buffer.flush(firstDraw * sizeof(VkDrawIndexedIndirectCommand),
+                 meshes.size() * sizeof(VkDrawIndexedIndirectCommand));
+    return meshes.size();
+  }
+
+  VertexBuffer<T> const &vertices() const noexcept { return m_vertices; }
+
+  IndexBuffer<type> const &indices() const noexcept { return m_indices; }
+
+  /// Number of vertices reserved by live meshes.
+  VkDeviceSize usedVertices() const noexcept {
+    return m_usedUnits(m_vertexBlock.get());
+  }
+
+  /// Number of indices reserved by live meshes.
+  VkDeviceSize usedIndices() const noexcept {
+    return m_usedUnits(m_indexBlock.get());
+  }
+
+private:
+  static VkDeviceSize m_usedUnits(VmaVirtualBlock block) noexcept {
+    VmaStatistics stats{};
+    vmaGetVirtualBlockStatistics(block, &stats);
+    return stats.allocationBytes;
+  }
+
+  VertexBuffer<T> m_vertices;
+  IndexBuffer<type> m_indices;
+  __detail::VirtualBlockPtr m_vertexBlock;
+  __detail::VirtualBlockPtr m_indexBlock;
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_MESHPOOL_HPP
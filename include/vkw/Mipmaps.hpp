@@ -0,0 +1,473 @@
+#ifndef VKWRAPPER_MIPMAPS_HPP
+#define VKWRAPPER_MIPMAPS_HPP
+
+#include <vkw/CommandRecorder.hpp>
+
+#include <array>
+#include <deque>
+#include <memory>
+
+namespace vkw {
+
+class FormatFeatureUnsupported final : public Error {
+public:
+  FormatFeatureUnsupported(VkFormat format,
+                           VkFormatFeatureFlags missing) noexcept
+      : Error([&]() {
+          std::stringstream ss;
+          ss << "Format " << format
+             << " lacks required format features: 0x" << std::hex
+             << missing;
+          return ss.str();
+        }()),
+        m_format(format), m_missing(missing) {}
+
+  VkFormat format() const noexcept { return m_format; }
+
+  VkFormatFeatureFlags missingFeatures() const noexcept { return m_missing; }
+
+  std::string_view codeString() const noexcept override {
+    return "Format feature unsupported";
+  }
+
+private:
+  VkFormat m_format;
+  VkFormatFeatureFlags m_missing;
+};
+
+namespace __detail {
+
+inline VkOffset3D m_mipExtent(VkExtent3D extent, uint32_t level) noexcept {
+  return VkOffset3D{static_cast<int32_t>(std::max(1u, extent.width >> level)),
+                    static_cast<int32_t>(std::max(1u, extent.height >> level)),
+                    static_cast<int32_t>(std::max(1u, extent.depth >> level))};
+}
+
+inline VkFormatFeatureFlags
+m_formatFeatures(Device const &device, ImageInterface const &image) noexcept {
+  auto properties = device.formatProperties(image.format());
+  return image.tiling() == VK_IMAGE_TILING_LINEAR
+             ? properties.linearTilingFeatures
+             : properties.optimalTilingFeatures;
+}
+
+constexpr VkFormatFeatureFlags m_blitFeatures =
+    VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+
+constexpr VkFormatFeatureFlags m_downsampleFeatures =
+    VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+
+// 2x2 box downsampling of one mip level of 2D array image, SPIR-V 1.0
+// assembled from:
+//
+//   #version 450
+//   #extension GL_EXT_samplerless_texture_functions : require
+//   layout(local_size_x = 8, local_size_y = 8) in;
+//   layout(binding = 0) uniform texture2DArray src;
+//   layout(binding = 1) uniform writeonly image2DArray dst;
+//
+//   void main() {
+//     ivec3 id = ivec3(gl_GlobalInvocationID);
+//     if (!all(lessThan(id.xy, imageSize(dst).xy)))
+//       return;
+//     ivec2 p0 = id.xy * 2;
+//     ivec2 p1 = min(p0 + 1, textureSize(src, 0).xy - 1);
+//     vec4 sum = texelFetch(src, ivec3(p0.x, p0.y, id.z), 0) +
+//                texelFetch(src, ivec3(p1.x, p0.y, id.z), 0) +
+//                texelFetch(src, ivec3(p0.x, p1.y, id.z), 0) +
+//                texelFetch(src, ivec3(p1.x, p1.y, id.z), 0);
+//     imageStore(dst, id, sum * 0.25);
+//   }
+//
+// Storage image has no format qualifier, so one pipeline serves every
+// float format (requires shaderStorageImageWriteWithoutFormat).
+inline constexpr unsigned m_downsampleCode[] = {
+    0x07230203, 0x00010000, 0x00000000, 0x0000003d, 0x00000000, 0x00020011,
+    0x00000001, 0x00020011, 0x00000032, 0x00020011, 0x00000038, 0x0006000b,
+    0x00000001, 0x4c534c47, 0x6474732e, 0x3035342e, 0x00000000, 0x0003000e,
+    0x00000000, 0x00000001, 0x0006000f, 0x00000005, 0x00000002, 0x6e69616d,
+    0x00000000, 0x00000003, 0x00060010, 0x00000002, 0x00000011, 0x00000008,
+    0x00000008, 0x00000001, 0x00040047, 0x00000003, 0x0000000b, 0x0000001c,
+    0x00040047, 0x00000004, 0x00000022, 0x00000000, 0x00040047, 0x00000004,
+    0x00000021, 0x00000000, 0x00040047, 0x00000005, 0x00000022, 0x00000000,
+    0x00040047, 0x00000005, 0x00000021, 0x00000001, 0x00030047, 0x00000005,
+    0x00000019, 0x00020013, 0x00000006, 0x00030021, 0x00000007, 0x00000006,
+    0x00020014, 0x00000008, 0x00040015, 0x00000009, 0x00000020, 0x00000001,
+    0x00040015, 0x0000000a, 0x00000020, 0x00000000, 0x00030016, 0x0000000b,
+    0x00000020, 0x00040017, 0x0000000c, 0x00000008, 0x00000002, 0x00040017,
+    0x0000000d, 0x00000009, 0x00000002, 0x00040017, 0x0000000e, 0x00000009,
+    0x00000003, 0x00040017, 0x0000000f, 0x0000000a, 0x00000003, 0x00040017,
+    0x00000010, 0x0000000b, 0x00000004, 0x00040020, 0x00000011, 0x00000001,
+    0x0000000f, 0x0004003b, 0x00000011, 0x00000003, 0x00000001, 0x00090019,
+    0x00000012, 0x0000000b, 0x00000001, 0x00000000, 0x00000001, 0x00000000,
+    0x00000001, 0x00000000, 0x00090019, 0x00000013, 0x0000000b, 0x00000001,
+    0x00000000, 0x00000001, 0x00000000, 0x00000002, 0x00000000, 0x00040020,
+    0x00000014, 0x00000000, 0x00000012, 0x00040020, 0x00000015, 0x00000000,
+    0x00000013, 0x0004003b, 0x00000014, 0x00000004, 0x00000000, 0x0004003b,
+    0x00000015, 0x00000005, 0x00000000, 0x0004002b, 0x00000009, 0x00000016,
+    0x00000000, 0x0004002b, 0x00000009, 0x00000017, 0x00000001, 0x0004002b,
+    0x0000000b, 0x00000018, 0x3e800000, 0x0005002c, 0x0000000d, 0x00000019,
+    0x00000017, 0x00000017, 0x00050036, 0x00000006, 0x00000002, 0x00000000,
+    0x00000007, 0x000200f8, 0x0000001a, 0x0004003d, 0x0000000f, 0x0000001b,
+    0x00000003, 0x0004007c, 0x0000000e, 0x0000001c, 0x0000001b, 0x0004003d,
+    0x00000013, 0x0000001d, 0x00000005, 0x00040068, 0x0000000e, 0x0000001e,
+    0x0000001d, 0x0007004f, 0x0000000d, 0x0000001f, 0x0000001c, 0x0000001c,
+    0x00000000, 0x00000001, 0x0007004f, 0x0000000d, 0x00000020, 0x0000001e,
+    0x0000001e, 0x00000000, 0x00000001, 0x000500b1, 0x0000000c, 0x00000021,
+    0x0000001f, 0x00000020, 0x0004009b, 0x00000008, 0x00000022, 0x00000021,
+    0x000300f7, 0x00000023, 0x00000000, 0x000400fa, 0x00000022, 0x00000024,
+    0x00000023, 0x000200f8, 0x00000024, 0x0004003d, 0x00000012, 0x00000025,
+    0x00000004, 0x00050067, 0x0000000e, 0x00000026, 0x00000025, 0x00000016,
+    0x0007004f, 0x0000000d, 0x00000027, 0x00000026, 0x00000026, 0x00000000,
+    0x00000001, 0x00050082, 0x0000000d, 0x00000028, 0x00000027, 0x00000019,
+    0x00050080, 0x0000000d, 0x00000029, 0x0000001f, 0x0000001f, 0x00050080,
+    0x0000000d, 0x0000002a, 0x00000029, 0x00000019, 0x0007000c, 0x0000000d,
+    0x0000002b, 0x00000001, 0x00000027, 0x0000002a, 0x00000028, 0x00050051,
+    0x00000009, 0x0000002c, 0x0000001c, 0x00000002, 0x00050051, 0x00000009,
+    0x0000002d, 0x00000029, 0x00000000, 0x00050051, 0x00000009, 0x0000002e,
+    0x00000029, 0x00000001, 0x00050051, 0x00000009, 0x0000002f, 0x0000002b,
+    0x00000000, 0x00050051, 0x00000009, 0x00000030, 0x0000002b, 0x00000001,
+    0x00060050, 0x0000000e, 0x00000031, 0x0000002d, 0x0000002e, 0x0000002c,
+    0x0007005f, 0x00000010, 0x00000032, 0x00000025, 0x00000031, 0x00000002,
+    0x00000016, 0x00060050, 0x0000000e, 0x00000033, 0x0000002f, 0x0000002e,
+    0x0000002c, 0x0007005f, 0x00000010, 0x00000034, 0x00000025, 0x00000033,
+    0x00000002, 0x00000016, 0x00060050, 0x0000000e, 0x00000035, 0x0000002d,
+    0x00000030, 0x0000002c, 0x0007005f, 0x00000010, 0x00000036, 0x00000025,
+    0x00000035, 0x00000002, 0x00000016, 0x00060050, 0x0000000e, 0x00000037,
+    0x0000002f, 0x00000030, 0x0000002c, 0x0007005f, 0x00000010, 0x00000038,
+    0x00000025, 0x00000037, 0x00000002, 0x00000016, 0x00050081, 0x00000010,
+    0x00000039, 0x00000032, 0x00000034, 0x00050081, 0x00000010, 0x0000003a,
+    0x00000039, 0x00000036, 0x00050081, 0x00000010, 0x0000003b, 0x0000003a,
+    0x00000038, 0x0005008e, 0x00000010, 0x0000003c, 0x0000003b, 0x00000018,
+    0x00040063, 0x0000001d, 0x0000001c, 0x0000003c, 0x000200f9, 0x00000023,
+    0x000200f8, 0x00000023, 0x000100fd, 0x00010038,
+};
+
+} // namespace __detail
+
+/**
+ * Fills mip levels [1, mipLevels) of the image by downsampling every level
+ * from the previous one with vkCmdBlitImage.
+ *
+ * All array layers of a level are blitted by a single command and every
+ * level costs exactly one barrier. Linear filtering is used when the format
+ * supports VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT, nearest
+ * otherwise.
+ *
+ * On entry every mip level must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+ * and level 0 must hold the source data. On exit the whole image is in
+ * finalLayout and is visible to dstStage/dstAccess.
+ *
+ * Formats without BLIT_SRC/BLIT_DST support are handled by MipmapGenerator.
+ */
+inline void generateMipmaps(
+    TransferPassRecorder &recorder, AllocatedImage const &image,
+    VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+    VkAccessFlags dstAccess =
+        VK_ACCESS_SHADER_READ_BIT) noexcept(ExceptionsDisabled) {
+  auto features = __detail::m_formatFeatures(recorder.device(), image);
+
+  constexpr auto blitFeatures = __detail::m_blitFeatures;
+  if ((features & blitFeatures) != blitFeatures)
+    postError(FormatFeatureUnsupported(image.format(),
+                                       blitFeatures & ~features));
+
+  auto filter = features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT
+                    ? VK_FILTER_LINEAR
+                    : VK_FILTER_NEAREST;
+
+  auto range = image.completeSubresourceRange();
+  auto extent = image.rawExtents();
+
+  VkImageMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.pNext = nullptr;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange = range;
+  barrier.subresourceRange.levelCount = 1;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+  for (uint32_t level = 1; level < range.levelCount; ++level) {
+    // Previous level has just been written, turn it into the blit source.
+    barrier.subresourceRange.baseMipLevel = level - 1;
+    recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT, {&barrier, 1});
+
+    VkImageBlit blit{};
+    blit.srcSubresource.aspectMask = range.aspectMask;
+    blit.srcSubresource.mipLevel = level - 1;
+    blit.srcSubresource.baseArrayLayer = 0;
+    blit.srcSubresource.layerCount = range.layerCount;
+    blit.srcOffsets[1] = __detail::m_mipExtent(extent, level - 1);
+    blit.dstSubresource = blit.srcSubresource;
+    blit.dstSubresource.mipLevel = level;
+    blit.dstOffsets[1] = __detail::m_mipExtent(extent, level);
+
+    recorder.blitImage(image, image, {&blit, 1}, filter);
+  }
+
+  // Every level except the last one is a blit source now, the last one is
+  // still a blit destination.
+  std::array<VkImageMemoryBarrier, 2> finalBarriers{barrier, barrier};
+  auto &sources = finalBarriers.at(0);
+  auto &last = finalBarriers.at(1);
+
+  sources.subresourceRange.baseMipLevel = 0;
+  sources.subresourceRange.levelCount = range.levelCount - 1;
+  sources.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  sources.newLayout = finalLayout;
+  sources.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  sources.dstAccessMask = dstAccess;
+
+  last.subresourceRange.baseMipLevel = range.levelCount - 1;
+  last.subresourceRange.levelCount = 1;
+  last.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  last.newLayout = finalLayout;
+  last.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  last.dstAccessMask = dstAccess;
+
+  auto barriers = std::span<const VkImageMemoryBarrier>(finalBarriers);
+  if (range.levelCount == 1)
+    barriers = barriers.subspan(1);
+
+  recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage,
+                              barriers);
+}
+
+/**
+ * @class MipmapResources
+ *
+ * descriptors and views used by compute mipmap generation. Must be kept
+ * alive until recorded commands complete. Empty if mipmaps were blitted.
+ */
+class MipmapResources {
+public:
+  MipmapResources() noexcept = default;
+
+private:
+  friend class MipmapGenerator;
+
+  std::unique_ptr<DescriptorPool> m_pool;
+  std::deque<vk::ImageView> m_views;
+  std::deque<DescriptorSet> m_sets;
+};
+
+enum class MipmapMethod {
+  /// Blit if format supports it, compute otherwise.
+  AUTO,
+  BLIT,
+  COMPUTE
+};
+
+/**
+ * @class MipmapGenerator
+ *
+ * generates mip chains with a compute downsampler for images that cannot be
+ * blitted, or for any supported image when COMPUTE is requested explicitly.
+ * Every level is averaged from 2x2 texels of the previous one by a single
+ * dispatch covering all array layers, with one barrier per level.
+ *
+ * Compute path supports 2D color images with float, normalized or scaled
+ * formats that have SAMPLED_IMAGE and STORAGE_IMAGE format features. Image
+ * must be created with SAMPLED and STORAGE usage, and device must have
+ * shaderStorageImageWriteWithoutFormat enabled. See supports().
+ *
+ * Generator must outlive resources it returns.
+ */
+class MipmapGenerator {
+public:
+  explicit MipmapGenerator(Device &device) noexcept(ExceptionsDisabled)
+      : m_setLayout(device,
+                    std::array{DescriptorSetLayoutBinding(
+                                   0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                                   VK_SHADER_STAGE_COMPUTE_BIT),
+                               DescriptorSetLayoutBinding(
+                                   1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                                   VK_SHADER_STAGE_COMPUTE_BIT)}),
+        m_layout(device, m_setLayout),
+        m_shader(device, SPIRVModule(__detail::m_downsampleCode)),
+        m_pipeline(device, ComputePipelineCreateInfo(m_layout, m_shader)) {}
+
+  /// Whether image can be processed by compute path.
+  static bool supports(Device const &device,
+                       ImageInterface const &image) noexcept {
+    constexpr VkImageUsageFlags usage =
+        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+    constexpr auto features = __detail::m_downsampleFeatures;
+    auto numeric = formatInfo(image.format()).numeric;
+
+    return image.type() == VK_IMAGE_TYPE_2D &&
+           ImageInterface::isColorFormat(image.format()) &&
+           numeric != FormatNumeric::UINT && numeric != FormatNumeric::SINT &&
+           (image.usage() & usage) == usage &&
+           (__detail::m_formatFeatures(device, image) & features) ==
+               features &&
+           device.physicalDevice()
+               .enabledFeatures()
+               .shaderStorageImageWriteWithoutFormat;
+  }
+
+  /**
+   * Records mip chain generation with method chosen as described by
+   * MipmapMethod. Layout requirements are the same as of generateMipmaps().
+   */
+  [[nodiscard]] MipmapResources generate(
+      BufferRecorder &recorder, AllocatedImage const &image,
+      MipmapMethod method = MipmapMethod::AUTO,
+      VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+      VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+      VkAccessFlags dstAccess =
+          VK_ACCESS_SHADER_READ_BIT) const noexcept(ExceptionsDisabled) {
+    if (method == MipmapMethod::AUTO) {
+      auto const &device = m_setLayout.parent();
+      auto features = __detail::m_formatFeatures(device, image);
+      bool blit = (features & __detail::m_blitFeatures) ==
+                      __detail::m_blitFeatures ||
+                  !supports(device, image);
+      method = blit ? MipmapMethod::BLIT : MipmapMethod::COMPUTE;
+    }
+
+    if (method == MipmapMethod::BLIT) {
+      auto transfer = recorder.beginTransferPass();
+      generateMipmaps(transfer, image, finalLayout, dstStage, dstAccess);
+      return {};
+    }
+
+    auto compute = recorder.beginComputePass();
+    return generate(compute, image, finalLayout, dstStage, dstAccess);
+  }
+
+  /**
+   * Records compute mip chain generation. On entry every mip level must be
+   * in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL and level 0 must hold the source
+   * data. On exit the whole image is in finalLayout and is visible to
+   * dstStage/dstAccess.
+   */
+  [[nodiscard]] MipmapResources generate(
+      ComputePassRecorder &recorder, AllocatedImage const &image,
+      VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+      VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+      VkAccessFlags dstAccess =
+          VK_ACCESS_SHADER_READ_BIT) const noexcept(ExceptionsDisabled) {
+    auto const &device = recorder.device();
+    constexpr auto requiredFeatures = __detail::m_downsampleFeatures;
+    auto features = __detail::m_formatFeatures(device, image);
+    if ((features & requiredFeatures) != requiredFeatures)
+      postError(FormatFeatureUnsupported(image.format(),
+                                         requiredFeatures & ~features));
+    assert(supports(device, image) &&
+           "image is not supported by compute mipmap generation");
+
+    auto range = image.completeSubresourceRange();
+    auto extent = image.rawExtents();
+
+    MipmapResources resources;
+    auto levels = range.levelCount;
+    std::array<VkDescriptorPoolSize, 2> poolSizes{
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, levels},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, levels}};
+    resources.m_pool =
+        std::make_unique<DescriptorPool>(device, levels, poolSizes);
+
+    for (uint32_t level = 0; level < levels; ++level) {
+      VkImageViewCreateInfo viewInfo{};
+      viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+      viewInfo.pNext = nullptr;
+      viewInfo.image = image;
+      viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+      viewInfo.format = image.format();
+      viewInfo.subresourceRange = range;
+      viewInfo.subresourceRange.baseMipLevel = level;
+      viewInfo.subresourceRange.levelCount = 1;
+      resources.m_views.emplace_back(device, viewInfo);
+    }
+
+    for (uint32_t level = 1; level < levels; ++level) {
+      auto &set = resources.m_sets.emplace_back(*resources.m_pool, m_setLayout);
+      std::array<VkDescriptorImageInfo, 2> imageInfos{
+          VkDescriptorImageInfo{VK_NULL_HANDLE,
+                                resources.m_views.at(level - 1),
+                                VK_IMAGE_LAYOUT_GENERAL},
+          VkDescriptorImageInfo{VK_NULL_HANDLE, resources.m_views.at(level),
+                                VK_IMAGE_LAYOUT_GENERAL}};
+      std::array<VkWriteDescriptorSet, 2> writes{};
+      for (uint32_t binding = 0; binding < writes.size(); ++binding) {
+        auto &write = writes.at(binding);
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.pNext = nullptr;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.dstArrayElement = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = binding == 0 ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
+                                            : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        write.pImageInfo = &imageInfos.at(binding);
+      }
+      device.core<1, 0>().vkUpdateDescriptorSets(device, writes.size(),
+                                                 writes.data(), 0, nullptr);
+    }
+
+    // Whole chain stays in GENERAL layout: every level but the last one is
+    // written and then read by the next dispatch.
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.pNext = nullptr;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = range;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                {&barrier, 1});
+
+    recorder.bindPipeline(m_pipeline);
+
+    barrier.subresourceRange.levelCount = 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    for (uint32_t level = 1; level < levels; ++level) {
+      // Previous level has just been written by the previous dispatch.
+      if (level > 1) {
+        barrier.subresourceRange.baseMipLevel = level - 1;
+        recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                    {&barrier, 1});
+      }
+
+      auto size = __detail::m_mipExtent(extent, level);
+      recorder.bindDescriptorSet(m_layout, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                 resources.m_sets.at(level - 1), 0);
+      recorder.dispatch((size.x + 7) / 8, (size.y + 7) / 8, range.layerCount);
+    }
+
+    barrier.subresourceRange = range;
+    barrier.newLayout = finalLayout;
+    barrier.dstAccessMask = dstAccess;
+    recorder.imageMemoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStage,
+                                {&barrier, 1});
+
+    return resources;
+  }
+
+private:
+  DescriptorSetLayout m_setLayout;
+  PipelineLayout m_layout;
+  ComputeShader m_shader;
+  ComputePipeline m_pipeline;
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_MIPMAPS_HPP
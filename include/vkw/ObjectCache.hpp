@@ -0,0 +1,235 @@
+#ifndef VKWRAPPER_OBJECTCACHE_HPP
+#define VKWRAPPER_OBJECTCACHE_HPP
+
+#include <vkw/Image.hpp>
+#include <vkw/Sampler.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace vkw {
+
+namespace __detail {
+
+inline size_t m_hashCombine(size_t seed, uint64_t value) noexcept {
+  return seed ^ (std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ull +
+                 (seed << 6) + (seed >> 2));
+}
+
+// Sampler infos are compared with float ==, so 0.0f and -0.0f must hash the
+// same.
+inline uint64_t m_floatBits(float value) noexcept {
+  return std::bit_cast<uint32_t>(value == 0.0f ? 0.0f : value);
+}
+
+struct SamplerInfoHash {
+  size_t operator()(VkSamplerCreateInfo const &info) const noexcept {
+    size_t ret = 0;
+    for (uint64_t value :
+         {uint64_t(info.flags), uint64_t(info.magFilter),
+          uint64_t(info.minFilter), uint64_t(info.mipmapMode),
+          uint64_t(info.addressModeU), uint64_t(info.addressModeV),
+          uint64_t(info.addressModeW), m_floatBits(info.mipLodBias),
+          uint64_t(info.anisotropyEnable), m_floatBits(info.maxAnisotropy),
+          uint64_t(info.compareEnable), uint64_t(info.compareOp),
+          m_floatBits(info.minLod), m_floatBits(info.maxLod),
+          uint64_t(info.borderColor), uint64_t(info.unnormalizedCoordinates)})
+      ret = m_hashCombine(ret, value);
+    return ret;
+  }
+};
+
+struct ImageViewInfoHash {
+  size_t operator()(VkImageViewCreateInfo const &info) const noexcept {
+    auto const &range = info.subresourceRange;
+    size_t ret = 0;
+    for (uint64_t value :
+         {reinterpret_cast<uint64_t>(info.image), uint64_t(info.flags),
+          uint64_t(info.viewType), uint64_t(info.format),
+          uint64_t(info.components.r), uint64_t(info.components.g),
+          uint64_t(info.components.b), uint64_t(info.components.a),
+          uint64_t(range.aspectMask), uint64_t(range.baseMipLevel),
+          uint64_t(range.levelCount), uint64_t(range.baseArrayLayer),
+          uint64_t(range.layerCount)})
+      ret = m_hashCombine(ret, value);
+    return ret;
+  }
+};
+
+// Create infos are plain Vulkan structs, their operator== is not found by
+// ADL from std::equal_to.
+struct InfoEqual {
+  template <typename Info>
+  bool operator()(Info const &lhs, Info const &rhs) const noexcept {
+    return vkw::operator==(lhs, rhs);
+  }
+};
+
+// Maps create infos to weakly held objects. Objects are destroyed as soon
+// as the last user releases them, expired entries are swept out once the
+// map doubles in size.
+template <typename Info, typename T, typename Hash> class WeakObjectCache {
+public:
+  template <typename Factory>
+  std::shared_ptr<T> get(Info const &info,
+                         Factory &&factory) noexcept(ExceptionsDisabled) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto found = m_entries.find(info);
+    if (found != m_entries.end()) {
+      if (auto object = found->second.lock())
+        return object;
+    }
+
+    std::shared_ptr<T> object = factory();
+    if (found != m_entries.end()) {
+      found->second = object;
+      return object;
+    }
+
+    if (m_entries.size() >= m_sweepThreshold) {
+      std::erase_if(m_entries,
+                    [](auto const &entry) { return entry.second.expired(); });
+      m_sweepThreshold = std::max<size_t>(64, m_entries.size() * 2);
+    }
+    m_entries.emplace(info, object);
+    return object;
+  }
+
+  /// Number of objects that are currently alive.
+  size_t size() const noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return std::count_if(
+        m_entries.begin(), m_entries.end(),
+        [](auto const &entry) { return !entry.second.expired(); });
+  }
+
+private:
+  mutable std::mutex m_mutex;
+  std::unordered_map<Info, std::weak_ptr<T>, Hash, InfoEqual> m_entries;
+  size_t m_sweepThreshold = 64;
+};
+
+} // namespace __detail
+
+/**
+ * @class SamplerCache
+ *
+ * interns samplers by their create info. Users requesting equal create
+ * infos share a single VkSampler which lives while any of them holds it.
+ *
+ * Create infos with pNext chain are not compared and always produce a new
+ * sampler.
+ */
+class SamplerCache {
+public:
+  explicit SamplerCache(Device const &device) noexcept : m_device(device) {}
+
+  std::shared_ptr<Sampler const>
+  get(VkSamplerCreateInfo const &createInfo) noexcept(ExceptionsDisabled) {
+    if (createInfo.pNext)
+      return std::make_shared<Sampler const>(m_device.get(), createInfo);
+
+    return m_cache.get(createInfo, [&]() {
+      return std::make_shared<Sampler const>(m_device.get(), createInfo);
+    });
+  }
+
+  /// Number of distinct samplers that are currently alive.
+  size_t size() const noexcept { return m_cache.size(); }
+
+private:
+  StrongReference<Device const> m_device;
+  __detail::WeakObjectCache<VkSamplerCreateInfo, Sampler const,
+                            __detail::SamplerInfoHash>
+      m_cache;
+};
+
+/**
+ * @class ImageViewCache
+ *
+ * interns image views by image, format, subresource range and component
+ * mapping. Arguments mirror ImageView constructors.
+ */
+class ImageViewCache {
+public:
+  explicit ImageViewCache(Device const &device) noexcept : m_device(device) {}
+
+  template <ImageViewType vtype, ImagePixelType ptype, ImageType itype>
+    requires CompatibleViewTypeC<itype, vtype>
+  std::shared_ptr<ImageView<ptype, vtype> const>
+  get(BasicImage<ptype, itype, ARRAY> const &image, VkFormat format,
+      unsigned baseLayer = 0, unsigned layerCount = 1,
+      unsigned baseMipLevel = 0, unsigned mipLevels = 1,
+      VkComponentMapping mapping = m_identityMapping,
+      VkImageViewCreateFlags flags = 0) noexcept(ExceptionsDisabled) {
+    auto key = m_key<ptype, vtype>(image, format, baseLayer, layerCount,
+                                   baseMipLevel, mipLevels, mapping, flags);
+    return std::dynamic_pointer_cast<ImageView<ptype, vtype> const>(
+        m_cache.get(key, [&]() {
+          return std::make_shared<ImageView<ptype, vtype> const>(
+              m_device.get(), image, format, baseLayer, layerCount,
+              baseMipLevel, mipLevels, mapping, flags);
+        }));
+  }
+
+  template <ImageViewType vtype, ImagePixelType ptype, ImageType itype>
+    requires CompatibleViewTypeC<itype, vtype>
+  std::shared_ptr<ImageView<ptype, vtype> const>
+  get(BasicImage<ptype, itype, SINGLE> const &image, VkFormat format,
+      unsigned baseMipLevel = 0, unsigned mipLevels = 1,
+      VkComponentMapping mapping = m_identityMapping,
+      VkImageViewCreateFlags flags = 0) noexcept(ExceptionsDisabled) {
+    auto key = m_key<ptype, vtype>(image, format, 0, 1, baseMipLevel,
+                                   mipLevels, mapping, flags);
+    return std::dynamic_pointer_cast<ImageView<ptype, vtype> const>(
+        m_cache.get(key, [&]() {
+          return std::make_shared<ImageView<ptype, vtype> const>(
+              m_device.get(), image, format, baseMipLevel, mipLevels, mapping,
+              flags);
+        }));
+  }
+
+  /// Number of distinct views that are currently alive.
+  size_t size() const noexcept { return m_cache.size(); }
+
+private:
+  static constexpr VkComponentMapping m_identityMapping{
+      .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+      .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+      .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+      .a = VK_COMPONENT_SWIZZLE_IDENTITY,
+  };
+
+  template <ImagePixelType ptype, ImageViewType vtype>
+  static VkImageViewCreateInfo
+  m_key(ImageInterface const &image, VkFormat format, unsigned baseLayer,
+        unsigned layerCount, unsigned baseMipLevel, unsigned mipLevels,
+        VkComponentMapping mapping, VkImageViewCreateFlags flags) noexcept {
+    VkImageViewCreateInfo ret{};
+    ret.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    ret.image = image;
+    ret.viewType = ImageViewTypeVal<vtype>::value;
+    ret.format = format;
+    ret.components = mapping;
+    ret.flags = flags;
+    ret.subresourceRange.aspectMask = ImageAspectVal<ptype>::value;
+    ret.subresourceRange.baseArrayLayer = baseLayer;
+    ret.subresourceRange.layerCount = layerCount;
+    ret.subresourceRange.baseMipLevel = baseMipLevel;
+    ret.subresourceRange.levelCount = mipLevels;
+    return ret;
+  }
+
+  StrongReference<Device const> m_device;
+  // Views keep their image alive through StrongReference, so an entry can
+  // only refer to a live image while it has not expired.
+  __detail::WeakObjectCache<VkImageViewCreateInfo, ImageViewBase const,
+                            __detail::ImageViewInfoHash>
+      m_cache;
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_OBJECTCACHE_HPP
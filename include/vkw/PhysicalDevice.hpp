@@ -4,7 +4,9 @@
 #include <vkw/Containers.hpp>
 #include <vkw/Instance.hpp>
 
+#include <new>
 #include <ranges>
+#include <vector>
 
 namespace vkw {
 
@@ -201,6 +203,94 @@ public:
   }
 #endif
 
+  /**
+   * Queries extension feature structure T identified by sType. If instance
+   * does not support Vulkan 1.1, every feature is reported unsupported.
+   */
+  template <typename T>
+  T supportedFeatures(VkStructureType sType) const noexcept {
+    T ret{};
+    ret.sType = sType;
+#ifdef VK_VERSION_1_1
+    if (!m_getFeatures2)
+      return ret;
+    VkPhysicalDeviceFeatures2 feats{};
+    feats.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    feats.pNext = &ret;
+    m_getFeatures2(m_physicalDevice, &feats);
+    ret.pNext = nullptr;
+#endif
+    return ret;
+  }
+
+  /**
+   * Fills extension property structure chained to VkPhysicalDeviceProperties2.
+   * sType of props must be set by caller. Returns false and leaves props
+   * untouched if instance does not support Vulkan 1.1.
+   */
+  template <typename T> bool queryProperties(T &props) const noexcept {
+#ifdef VK_VERSION_1_1
+    if (!m_getProperties2)
+      return false;
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &props;
+    props.pNext = nullptr;
+    m_getProperties2(m_physicalDevice, &properties);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * Returns extension feature structure T identified by sType that will be
+   * chained to device create info. Structure is added zero-initialized on
+   * first call, features set in it are requested on device creation.
+   */
+  template <typename T> T &enableFeatures(VkStructureType sType) noexcept {
+    if (auto *found = m_findEnabledFeatures(sType))
+      return *reinterpret_cast<T *>(found);
+    auto &blob = m_enabledFeatureChain.emplace_back(sizeof(T));
+    auto *ret = new (blob.data()) T{};
+    ret->sType = sType;
+    return *ret;
+  }
+
+  /// Returns enabled extension feature structure or nullptr if none.
+  template <typename T>
+  T const *enabledFeatures(VkStructureType sType) const noexcept {
+    return reinterpret_cast<T const *>(m_findEnabledFeatures(sType));
+  }
+
+#ifdef VK_VERSION_1_2
+  /**
+   * Enables bufferDeviceAddress feature. On devices created with api version
+   * below 1.2 VK_KHR_buffer_device_address is enabled as well.
+   */
+  void enableBufferDeviceAddress() noexcept(ExceptionsDisabled) {
+    constexpr auto sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES;
+    auto supported =
+        supportedFeatures<VkPhysicalDeviceBufferDeviceAddressFeatures>(sType);
+    if (!supported.bufferDeviceAddress)
+      postError(FeatureUnsupported(sType, "bufferDeviceAddress"));
+
+    if (m_requestedApiVersion < ApiVersion(1, 2, 0))
+      enableExtension(ext::KHR_buffer_device_address);
+
+    enableFeatures<VkPhysicalDeviceBufferDeviceAddressFeatures>(sType)
+        .bufferDeviceAddress = VK_TRUE;
+  }
+
+  bool bufferDeviceAddressEnabled() const noexcept {
+    auto const *features =
+        enabledFeatures<VkPhysicalDeviceBufferDeviceAddressFeatures>(
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES);
+    return features && features->bufferDeviceAddress;
+  }
+#endif
+
   auto supportedExtensions() const noexcept {
     return std::ranges::subrange(m_supportedExtensions.begin(),
                                  m_supportedExtensions.end());
@@ -324,6 +414,41 @@ public:
   }
 
 private:
+  friend class DeviceInfo;
+
+  VkBaseOutStructure *m_findEnabledFeatures(VkStructureType sType) noexcept {
+    for (auto &blob : m_enabledFeatureChain) {
+      auto *base = reinterpret_cast<VkBaseOutStructure *>(blob.data());
+      if (base->sType == sType)
+        return base;
+    }
+    return nullptr;
+  }
+
+  VkBaseOutStructure const *
+  m_findEnabledFeatures(VkStructureType sType) const noexcept {
+    return const_cast<PhysicalDevice *>(this)->m_findEnabledFeatures(sType);
+  }
+
+  // Links enabled feature structures into a pNext chain for device creation.
+  // Must be called on the copy that outlives device creation since chain
+  // points into its storage.
+  void *m_linkEnabledFeatures() noexcept {
+    VkBaseOutStructure *head = nullptr;
+    for (auto &blob : m_enabledFeatureChain | std::views::reverse) {
+      auto *base = reinterpret_cast<VkBaseOutStructure *>(blob.data());
+      base->pNext = head;
+      head = base;
+    }
+#ifdef VK_VERSION_1_2
+    if (m_requestedApiVersion >= ApiVersion(1, 1, 0)) {
+      m_enabledVulkan11Features.pNext = head;
+      return &m_enabledVulkan11Features;
+    }
+#endif
+    return head;
+  }
+
   PhysicalDevice(Instance const &instance,
                  VkPhysicalDevice device) noexcept(ExceptionsDisabled)
       : m_physicalDevice(device) {
@@ -350,6 +475,12 @@ private:
       instance.core<1, 1>().vkGetPhysicalDeviceFeatures2(m_physicalDevice,
                                                          &feats);
     }
+#endif
+#ifdef VK_VERSION_1_1
+    if (instance.apiVersion() >= ApiVersion(1, 1, 0)) {
+      m_getFeatures2 = instance.core<1, 1>().vkGetPhysicalDeviceFeatures2;
+      m_getProperties2 = instance.core<1, 1>().vkGetPhysicalDeviceProperties2;
+    }
 #endif
     // Memory properties are used regularly for creating all kinds of buffers
     instance.core<1, 0>().vkGetPhysicalDeviceMemoryProperties(
@@ -407,6 +538,13 @@ private:
   VkPhysicalDeviceVulkan11Features m_enabledVulkan11Features{};
 #endif
 
+  /** @brief Extension feature structures chained to device create info */
+  cntr::vector<std::vector<unsigned char>, 2> m_enabledFeatureChain{};
+#ifdef VK_VERSION_1_1
+  PFN_vkGetPhysicalDeviceFeatures2 m_getFeatures2 = nullptr;
+  PFN_vkGetPhysicalDeviceProperties2 m_getProperties2 = nullptr;
+#endif
+
   /** @brief Memory types and heaps of the physical device */
   VkPhysicalDeviceMemoryProperties m_memoryProperties{};
   /** @brief Queue family properties of the physical device */
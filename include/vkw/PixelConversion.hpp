@@ -0,0 +1,388 @@
+#ifndef VKWRAPPER_PIXELCONVERSION_HPP
+#define VKWRAPPER_PIXELCONVERSION_HPP
+
+#include <vkw/StagingBuffer.hpp>
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+#if defined(__SSE4_1__) || defined(__AVX2__) || defined(__F16C__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace vkw {
+
+/**
+ * Pixel conversion kernels for preparing texture data on the host.
+ *
+ * Every kernel converts src into dst, which may point to mapped staging
+ * memory directly. Pixel count is derived from src, dst must be large
+ * enough to hold converted pixels. Vector paths are chosen at compile time:
+ *
+ *   RGB8/BGR8 expansion, BGRA8 swizzle:   AVX2, SSE4.1, NEON
+ *   f32 to f16:                           F16C, NEON (AArch64 only)
+ *   linear to sRGB8 (table indices):      SSE4.1, NEON
+ *
+ * Everything else, and every kernel without enabled instruction set, runs
+ * scalar code. Results are identical on every path.
+ */
+
+namespace __detail {
+
+// Converts pixels [begin, end) with scalar code.
+inline void m_expandRGB8(uint8_t const *src, uint8_t *dst, size_t begin,
+                         size_t end, bool swapRB, uint8_t alpha) noexcept {
+  auto r = swapRB ? 2 : 0;
+  auto b = swapRB ? 0 : 2;
+  for (auto i = begin; i < end; ++i) {
+    dst[4 * i + 0] = src[3 * i + r];
+    dst[4 * i + 1] = src[3 * i + 1];
+    dst[4 * i + 2] = src[3 * i + b];
+    dst[4 * i + 3] = alpha;
+  }
+}
+
+inline void m_expandRGB8(std::span<const uint8_t> src, std::span<uint8_t> dst,
+                         bool swapRB, uint8_t alpha) noexcept {
+  auto count = src.size() / 3;
+  assert(dst.size() >= count * 4 && "destination is too small");
+  size_t i = 0;
+  auto const *in = src.data();
+  auto *out = dst.data();
+
+#if defined(__AVX2__)
+  {
+    auto shuffle = swapRB ? _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7,
+                                             6, -1, 11, 10, 9, -1, 2, 1, 0,
+                                             -1, 5, 4, 3, -1, 8, 7, 6, -1, 11,
+                                             10, 9, -1)
+                          : _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7,
+                                             8, -1, 9, 10, 11, -1, 0, 1, 2,
+                                             -1, 3, 4, 5, -1, 6, 7, 8, -1, 9,
+                                             10, 11, -1);
+    auto alphaMask = _mm256_set1_epi32(static_cast<int>(uint32_t(alpha) << 24));
+    // Every 16 byte load covers 4 pixels and reads 4 bytes past them, so
+    // the loop stops while there is still input to over-read.
+    for (; i + 10 <= count; i += 8) {
+      auto lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + 3 * i));
+      auto hi =
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + 3 * i + 12));
+      auto v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+      v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), alphaMask);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 4 * i), v);
+    }
+  }
+#endif
+#if defined(__SSE4_1__)
+  {
+    auto shuffle = swapRB ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6,
+                                          -1, 11, 10, 9, -1)
+                          : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8,
+                                          -1, 9, 10, 11, -1);
+    auto alphaMask = _mm_set1_epi32(static_cast<int>(uint32_t(alpha) << 24));
+    for (; i + 6 <= count; i += 4) {
+      auto v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + 3 * i));
+      v = _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alphaMask);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4 * i), v);
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 16 <= count; i += 16) {
+    auto rgb = vld3q_u8(in + 3 * i);
+    uint8x16x4_t rgba;
+    rgba.val[0] = swapRB ? rgb.val[2] : rgb.val[0];
+    rgba.val[1] = rgb.val[1];
+    rgba.val[2] = swapRB ? rgb.val[0] : rgb.val[2];
+    rgba.val[3] = vdupq_n_u8(alpha);
+    vst4q_u8(out + 4 * i, rgba);
+  }
+#endif
+
+  m_expandRGB8(in, out, i, count, swapRB, alpha);
+}
+
+// IEEE 754 binary32 to binary16 with round to nearest even, matches F16C.
+inline uint16_t m_floatToHalf(float value) noexcept {
+  auto bits = std::bit_cast<uint32_t>(value);
+  uint32_t sign = (bits >> 16) & 0x8000u;
+  uint32_t abs = bits & 0x7FFFFFFFu;
+
+  if (abs > 0x7F800000u) // NaN, keep it quiet
+    return sign | 0x7E00u | ((abs >> 13) & 0x3FFu);
+  if (abs >= 0x477FF000u) // rounds to infinity
+    return sign | 0x7C00u;
+  if (abs < 0x38800000u) {
+    // Result is subnormal or zero.
+    if (abs < 0x33000000u)
+      return sign;
+    uint32_t shift = 126u - (abs >> 23);
+    uint32_t mantissa = (abs & 0x7FFFFFu) | 0x800000u;
+    uint32_t ret = mantissa >> shift;
+    uint32_t rest = mantissa & ((1u << shift) - 1u);
+    uint32_t half = 1u << (shift - 1u);
+    if (rest > half || (rest == half && (ret & 1u)))
+      ++ret;
+    return sign | ret;
+  }
+
+  uint32_t ret = (abs - 0x38000000u) >> 13;
+  uint32_t rest = abs & 0x1FFFu;
+  if (rest > 0x1000u || (rest == 0x1000u && (ret & 1u)))
+    ++ret;
+  return sign | ret;
+}
+
+inline constexpr uint32_t m_srgbTableSize = 1u << 14;
+
+// Linear value quantized to 14 bits maps to 8 bit sRGB code. Step is fine
+// enough for the steepest part of the curve near zero.
+inline std::array<uint8_t, m_srgbTableSize + 1> const &m_srgbTable() noexcept {
+  static auto const table = []() {
+    std::array<uint8_t, m_srgbTableSize + 1> ret{};
+    for (uint32_t i = 0; i <= m_srgbTableSize; ++i) {
+      auto linear = static_cast<double>(i) / m_srgbTableSize;
+      auto srgb = linear <= 0.0031308 ? linear * 12.92
+                                      : 1.055 * std::pow(linear, 1.0 / 2.4) -
+                                            0.055;
+      ret[i] = static_cast<uint8_t>(srgb * 255.0 + 0.5);
+    }
+    return ret;
+  }();
+  return table;
+}
+
+// NaN and negative values map to 0, values above 1 map to the last index.
+inline uint32_t m_srgbIndex(float value) noexcept {
+  auto clamped = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+  return static_cast<uint32_t>(clamped * m_srgbTableSize + 0.5f);
+}
+
+inline uint8_t m_unorm8(float value) noexcept {
+  auto clamped = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+  return static_cast<uint8_t>(clamped * 255.0f + 0.5f);
+}
+
+// Computes table indices for 4 values at once.
+inline void m_srgbIndices(float const *src, uint32_t *indices) noexcept {
+#if defined(__SSE4_1__)
+  auto v = _mm_loadu_ps(src);
+  v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  v = _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(float(m_srgbTableSize))),
+                 _mm_set1_ps(0.5f));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(indices), _mm_cvttps_epi32(v));
+#elif defined(__ARM_NEON)
+  auto v = vld1q_f32(src);
+  // vmaxq_f32 propagates NaN, so compare explicitly to send it to zero.
+  v = vbslq_f32(vcgtq_f32(v, vdupq_n_f32(0.0f)), v, vdupq_n_f32(0.0f));
+  v = vminq_f32(v, vdupq_n_f32(1.0f));
+  v = vmlaq_n_f32(vdupq_n_f32(0.5f), v, float(m_srgbTableSize));
+  vst1q_u32(indices, vcvtq_u32_f32(v));
+#else
+  for (int i = 0; i < 4; ++i)
+    indices[i] = m_srgbIndex(src[i]);
+#endif
+}
+
+} // namespace __detail
+
+/** Expands RGB8 pixels to RGBA8 with constant alpha. */
+inline void convertRGB8ToRGBA8(std::span<const uint8_t> src,
+                               std::span<uint8_t> dst,
+                               uint8_t alpha = 0xFF) noexcept {
+  __detail::m_expandRGB8(src, dst, false, alpha);
+}
+
+/** Expands BGR8 pixels to RGBA8 with constant alpha. */
+inline void convertBGR8ToRGBA8(std::span<const uint8_t> src,
+                               std::span<uint8_t> dst,
+                               uint8_t alpha = 0xFF) noexcept {
+  __detail::m_expandRGB8(src, dst, true, alpha);
+}
+
+/** Swaps red and blue of 4 byte pixels: BGRA8 <-> RGBA8. May be in place. */
+inline void swizzleBGRA8ToRGBA8(std::span<const uint8_t> src,
+                                std::span<uint8_t> dst) noexcept {
+  auto count = src.size() / 4;
+  assert(dst.size() >= count * 4 && "destination is too small");
+  size_t i = 0;
+  auto const *in = src.data();
+  auto *out = dst.data();
+
+#if defined(__AVX2__)
+  {
+    auto shuffle =
+        _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                         2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    for (; i + 8 <= count; i += 8) {
+      auto v =
+          _mm256_loadu_si256(reinterpret_cast<__m256i const *>(in + 4 * i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 4 * i),
+                          _mm256_shuffle_epi8(v, shuffle));
+    }
+  }
+#endif
+#if defined(__SSE4_1__)
+  {
+    auto shuffle =
+        _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    for (; i + 4 <= count; i += 4) {
+      auto v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(in + 4 * i));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4 * i),
+                       _mm_shuffle_epi8(v, shuffle));
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 16 <= count; i += 16) {
+    auto v = vld4q_u8(in + 4 * i);
+    std::swap(v.val[0], v.val[2]);
+    vst4q_u8(out + 4 * i, v);
+  }
+#endif
+
+  for (; i < count; ++i) {
+    auto r = in[4 * i + 2];
+    auto b = in[4 * i + 0];
+    out[4 * i + 0] = r;
+    out[4 * i + 1] = in[4 * i + 1];
+    out[4 * i + 2] = b;
+    out[4 * i + 3] = in[4 * i + 3];
+  }
+}
+
+/** Converts floats to half floats rounding to nearest even. */
+inline void convertF32ToF16(std::span<const float> src,
+                            std::span<uint16_t> dst) noexcept {
+  assert(dst.size() >= src.size() && "destination is too small");
+  size_t i = 0;
+  auto count = src.size();
+
+#if defined(__F16C__)
+  for (; i + 8 <= count; i += 8) {
+    auto v = _mm256_loadu_ps(src.data() + i);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst.data() + i),
+                     _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; i + 4 <= count; i += 4) {
+    auto v = vcvt_f16_f32(vld1q_f32(src.data() + i));
+    vst1_u16(dst.data() + i, vreinterpret_u16_f16(v));
+  }
+#endif
+
+  for (; i < count; ++i)
+    dst[i] = __detail::m_floatToHalf(src[i]);
+}
+
+/** Encodes linear values in [0, 1] with sRGB transfer function. */
+inline void convertLinearToSRGB8(std::span<const float> src,
+                                 std::span<uint8_t> dst) noexcept {
+  assert(dst.size() >= src.size() && "destination is too small");
+  auto const &table = __detail::m_srgbTable();
+  size_t i = 0;
+  for (; i + 4 <= src.size(); i += 4) {
+    uint32_t indices[4];
+    __detail::m_srgbIndices(src.data() + i, indices);
+    for (int j = 0; j < 4; ++j)
+      dst[i + j] = table[indices[j]];
+  }
+  for (; i < src.size(); ++i)
+    dst[i] = table[__detail::m_srgbIndex(src[i])];
+}
+
+/**
+ * Converts linear RGBA32F pixels to R8G8B8A8_SRGB data. Alpha is not
+ * affected by sRGB encoding and is stored linearly.
+ */
+inline void convertLinearRGBA32FToSRGBA8(std::span<const float> src,
+                                         std::span<uint8_t> dst) noexcept {
+  assert(dst.size() >= src.size() && "destination is too small");
+  auto const &table = __detail::m_srgbTable();
+  for (size_t i = 0; i + 4 <= src.size(); i += 4) {
+    uint32_t indices[4];
+    __detail::m_srgbIndices(src.data() + i, indices);
+    dst[i + 0] = table[indices[0]];
+    dst[i + 1] = table[indices[1]];
+    dst[i + 2] = table[indices[2]];
+    dst[i + 3] = __detail::m_unorm8(src[i + 3]);
+  }
+}
+
+/** Conversions available for texture uploads. */
+enum class PixelConversion {
+  NONE,
+  RGB8_TO_RGBA8,
+  BGR8_TO_RGBA8,
+  BGRA8_TO_RGBA8,
+  RGBA32F_TO_RGBA16F,
+  RGBA32F_TO_SRGBA8
+};
+
+/** Size in bytes of srcSize bytes of pixels after conversion. */
+constexpr size_t convertedSize(PixelConversion conversion,
+                               size_t srcSize) noexcept {
+  switch (conversion) {
+  case PixelConversion::RGB8_TO_RGBA8:
+  case PixelConversion::BGR8_TO_RGBA8:
+    return srcSize / 3 * 4;
+  case PixelConversion::RGBA32F_TO_RGBA16F:
+    return srcSize / 2;
+  case PixelConversion::RGBA32F_TO_SRGBA8:
+    return srcSize / 4;
+  default:
+    return srcSize;
+  }
+}
+
+inline void convertPixels(PixelConversion conversion,
+                          std::span<const unsigned char> src,
+                          std::span<unsigned char> dst) noexcept {
+  auto floats = std::span<const float>(
+      reinterpret_cast<float const *>(src.data()), src.size() / sizeof(float));
+  switch (conversion) {
+  case PixelConversion::RGB8_TO_RGBA8:
+    convertRGB8ToRGBA8(src, dst);
+    break;
+  case PixelConversion::BGR8_TO_RGBA8:
+    convertBGR8ToRGBA8(src, dst);
+    break;
+  case PixelConversion::BGRA8_TO_RGBA8:
+    swizzleBGRA8ToRGBA8(src, dst);
+    break;
+  case PixelConversion::RGBA32F_TO_RGBA16F:
+    convertF32ToF16(floats,
+                    {reinterpret_cast<uint16_t *>(dst.data()),
+                     dst.size() / sizeof(uint16_t)});
+    break;
+  case PixelConversion::RGBA32F_TO_SRGBA8:
+    convertLinearRGBA32FToSRGBA8(floats, dst);
+    break;
+  default:
+    assert(dst.size() >= src.size() && "destination is too small");
+    std::copy(src.begin(), src.end(), dst.begin());
+  }
+}
+
+/**
+ * Creates staging buffer holding converted pixels. Conversion writes
+ * straight into mapped staging memory.
+ */
+inline StagingBuffer<unsigned char>
+stageConverted(DeviceAllocator &allocator, PixelConversion conversion,
+               std::span<const unsigned char> src) noexcept(
+    ExceptionsDisabled) {
+  StagingBuffer<unsigned char> ret{allocator,
+                                   convertedSize(conversion, src.size())};
+  convertPixels(conversion, src, ret.mapped());
+  ret.flush();
+  return ret;
+}
+
+} // namespace vkw
+#endif // VKWRAPPER_PIXELCONVERSION_HPP
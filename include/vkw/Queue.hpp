@@ -3,6 +3,7 @@
 
 #include <vkw/CommandBuffer.hpp>
 #include <vkw/Containers.hpp>
+#include <vkw/Expected.hpp>
 #include <vkw/RangeConcepts.hpp>
 #include <vkw/Semaphore.hpp>
 #include <vkw/Surface.hpp>
@@ -403,6 +404,20 @@ public:
     m_submit(m_infos.data(), m_infos.size(), nullptr);
   }
 
+  /** Submission that returns errors (e.g. VK_ERROR_DEVICE_LOST) instead of
+   * posting them. **/
+
+  Expected<void> try_submit(SubmitInfo const &info) const noexcept {
+    VkSubmitInfo rawInfo = info;
+    return m_trySubmit(&rawInfo, 1, nullptr);
+  }
+
+  Expected<void> try_submit(SubmitInfo const &info,
+                            Fence const &fence) const noexcept {
+    VkSubmitInfo rawInfo = info;
+    return m_trySubmit(&rawInfo, 1, &fence);
+  }
+
   QueueFamily const &family() const noexcept(ExceptionsDisabled) {
     return *(m_parent.get().physicalDevice().queueFamilies().begin() +
              m_familyIndex);
@@ -449,6 +464,16 @@ private:
         m_queue, infoCount, info,
         fence ? fence->operator VkFence_T *() : VK_NULL_HANDLE));
   }
+
+  Expected<void> m_trySubmit(VkSubmitInfo const *info, size_t infoCount,
+                             Fence const *fence) const noexcept {
+    auto result = m_parent.get().core<1, 0>().vkQueueSubmit(
+        m_queue, infoCount, info,
+        fence ? fence->operator VkFence_T *() : VK_NULL_HANDLE);
+    if (result != VK_SUCCESS)
+      return Unexpected{result};
+    return {};
+  }
   StrongReference<Device> m_parent;
   VkQueue m_queue = VK_NULL_HANDLE;
   uint32_t m_familyIndex;
@@ -0,0 +1,300 @@
+#ifndef VKWRAPPER_READBACKMANAGER_HPP
+#define VKWRAPPER_READBACKMANAGER_HPP
+
+#include <vkw/CommandRecorder.hpp>
+#include <vkw/Fence.hpp>
+#include <vkw/Format.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace vkw {
+
+class ReadbackManager;
+
+/**
+ * @class ReadbackData
+ *
+ * holds bytes read back from the device. Staging memory is returned to the
+ * manager once data is destroyed, so it should not be held longer than
+ * needed. Manager must outlive all data it has produced.
+ */
+class ReadbackData {
+public:
+  ReadbackData(ReadbackData &&another) noexcept
+      : m_manager(std::exchange(another.m_manager, nullptr)),
+        m_slot(std::exchange(another.m_slot, nullptr)),
+        m_data(another.m_data) {}
+  ReadbackData &operator=(ReadbackData &&another) noexcept {
+    std::swap(m_manager, another.m_manager);
+    std::swap(m_slot, another.m_slot);
+    std::swap(m_data, another.m_data);
+    return *this;
+  }
+
+  std::span<const unsigned char> data() const noexcept { return m_data; }
+
+  template <typename T> std::span<const T> as() const noexcept {
+    return {reinterpret_cast<T const *>(m_data.data()),
+            m_data.size() / sizeof(T)};
+  }
+
+  inline ~ReadbackData();
+
+private:
+  friend class ReadbackManager;
+
+  ReadbackData(ReadbackManager &manager, Buffer<unsigned char> &slot,
+               VkDeviceSize size) noexcept
+      : m_manager(&manager), m_slot(&slot),
+        m_data(slot.mapped().subspan(0, size)) {}
+
+  ReadbackManager *m_manager;
+  Buffer<unsigned char> *m_slot;
+  std::span<const unsigned char> m_data;
+};
+
+/**
+ * @class ReadbackManager
+ *
+ * records device to host copies into host cached staging buffers and
+ * resolves them on a worker thread, so submitting thread never waits for
+ * the device.
+ *
+ * Usage: record one or more reads into a command buffer, submit it with a
+ * fence and pass that fence to submitted(). Futures returned by reads made
+ * since previous submitted() call become ready once the fence is signaled.
+ * Fence must not be reset or destroyed until then.
+ *
+ * Staging buffers are reused: a buffer returns to the free list when its
+ * ReadbackData is destroyed. Destructor waits for fences of all submitted
+ * reads, so staging buffers are never freed while device still writes into
+ * them; futures that are still pending then are abandoned. Every recorded
+ * read must be passed to submitted() before manager is destroyed.
+ *
+ * If waiting for the fence or invalidating staging memory fails (e.g.
+ * VK_ERROR_DEVICE_LOST), VulkanError is stored in the affected futures and
+ * rethrown by get(). Without exceptions such error is irrecoverable.
+ */
+class ReadbackManager {
+public:
+  explicit ReadbackManager(DeviceAllocator &allocator) noexcept(
+      ExceptionsDisabled)
+      : m_allocator(allocator), m_worker([this]() { m_work(); }) {}
+
+  ReadbackManager(ReadbackManager const &another) = delete;
+  ReadbackManager &operator=(ReadbackManager const &another) = delete;
+
+  std::future<ReadbackData>
+  readBuffer(TransferPassRecorder &recorder, BufferBase const &src,
+             VkDeviceSize offset,
+             VkDeviceSize size) noexcept(ExceptionsDisabled) {
+    auto &slot = m_acquire(size);
+
+    VkBufferCopy region{};
+    region.srcOffset = offset;
+    region.dstOffset = 0;
+    region.size = size;
+    recorder.copyBufferToBuffer(src, slot, {&region, 1});
+
+    return m_record(recorder, slot, size);
+  }
+
+  /**
+   * Reads region of the image. Image must be in layout suitable for
+   * transfer source and previous writes must be visible to transfer reads.
+   * Data is tightly packed.
+   */
+  std::future<ReadbackData>
+  readImage(TransferPassRecorder &recorder, AllocatedImage const &src,
+            VkImageLayout layout, VkImageSubresourceLayers subresource,
+            VkOffset3D offset,
+            VkExtent3D extent) noexcept(ExceptionsDisabled) {
+    auto size = formatDataSize(src.format(), extent) * subresource.layerCount;
+    auto &slot = m_acquire(size);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource = subresource;
+    region.imageOffset = offset;
+    region.imageExtent = extent;
+    recorder.copyImageToBuffer(src, layout, slot, {&region, 1});
+
+    return m_record(recorder, slot, size);
+  }
+
+  /// Binds reads recorded since previous call to fence of their submission.
+  void submitted(Fence &fence) noexcept(ExceptionsDisabled) {
+    if (m_recorded.empty())
+      return;
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_batches.push_back(Batch{&fence, std::move(m_recorded)});
+    }
+    m_recorded.clear();
+    m_cv.notify_one();
+  }
+
+  /// Number of staging buffers owned by manager.
+  size_t stagingBufferCount() const noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_slots.size();
+  }
+
+  ~ReadbackManager() {
+    assert(m_recorded.empty() &&
+           "reads were recorded but never passed to submitted()");
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_stop = true;
+    }
+    m_cv.notify_one();
+    m_worker.join();
+  }
+
+private:
+  friend class ReadbackData;
+
+  struct Pending {
+    Buffer<unsigned char> *slot;
+    VkDeviceSize size;
+    std::promise<ReadbackData> promise;
+  };
+
+  struct Batch {
+    Fence *fence;
+    std::vector<Pending> reads;
+  };
+
+  Buffer<unsigned char> &m_acquire(VkDeviceSize size) noexcept(
+      ExceptionsDisabled) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    // Smallest free buffer that fits.
+    auto found = std::ranges::min_element(
+        m_free, std::less<>{}, [size](Buffer<unsigned char> *slot) {
+          return slot->size() >= size ? slot->size() : UINT64_MAX;
+        });
+    if (found != m_free.end() && (*found)->size() >= size) {
+      auto *slot = *found;
+      m_free.erase(found);
+      return *slot;
+    }
+
+    auto &slot = m_slots.emplace_back(std::make_unique<Buffer<unsigned char>>(
+        m_allocator, std::bit_ceil(std::max<VkDeviceSize>(size, 256)),
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        AllocationCreateInfo{
+            .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
+            .usage = VMA_MEMORY_USAGE_GPU_TO_CPU,
+            .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+            .preferredFlags = VK_MEMORY_PROPERTY_HOST_CACHED_BIT}));
+    return *slot;
+  }
+
+  void m_release(Buffer<unsigned char> &slot) noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_free.push_back(&slot);
+  }
+
+  std::future<ReadbackData> m_record(TransferPassRecorder &recorder,
+                                     Buffer<unsigned char> &slot,
+                                     VkDeviceSize size) noexcept(
+      ExceptionsDisabled) {
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = slot;
+    barrier.offset = 0;
+    barrier.size = size;
+    recorder.bufferMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_HOST_BIT, {&barrier, 1});
+
+    auto &pending = m_recorded.emplace_back(Pending{&slot, size, {}});
+    return pending.promise.get_future();
+  }
+
+  void m_work() noexcept {
+    for (;;) {
+      Batch batch;
+      {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_cv.wait(lock, [this]() { return m_stop || !m_batches.empty(); });
+        // Batches left at stop are still drained: their staging buffers
+        // must outlive device writes.
+        if (m_batches.empty())
+          return;
+        batch = std::move(m_batches.front());
+        m_batches.pop_front();
+      }
+
+      auto signaled = batch.fence->try_wait();
+      if (!signaled) {
+        m_fail(batch, VulkanError(signaled.error(), __FILE__, __LINE__));
+        continue;
+      }
+
+      {
+        // Data would outlive the manager, abandon the futures instead.
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_stop)
+          continue;
+      }
+
+      for (auto &read : batch.reads) {
+#ifdef VKW_ENABLE_EXCEPTIONS
+        try {
+          read.slot->invalidate(0, read.size);
+        } catch (...) {
+          m_release(*read.slot);
+          read.promise.set_exception(std::current_exception());
+          continue;
+        }
+#else
+        read.slot->invalidate(0, read.size);
+#endif
+        read.promise.set_value(ReadbackData{*this, *read.slot, read.size});
+      }
+    }
+  }
+
+  // Worker thread must not throw, so error is handed over to the futures.
+  void m_fail(Batch &batch, VulkanError const &error) noexcept {
+#ifdef VKW_ENABLE_EXCEPTIONS
+    for (auto &read : batch.reads) {
+      m_release(*read.slot);
+      read.promise.set_exception(std::make_exception_ptr(error));
+    }
+#else
+    irrecoverableError(error);
+#endif
+  }
+
+  DeviceAllocator &m_allocator;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop = false;
+  std::vector<std::unique_ptr<Buffer<unsigned char>>> m_slots;
+  std::vector<Buffer<unsigned char> *> m_free;
+  // Reads recorded by the submitting thread, not yet bound to a fence.
+  std::vector<Pending> m_recorded;
+  std::deque<Batch> m_batches;
+  // Declared last so that everything it touches is constructed before it
+  // starts and is still alive when it is joined.
+  std::thread m_worker;
+};
+
+ReadbackData::~ReadbackData() {
+  if (m_manager)
+    m_manager->m_release(*m_slot);
+}
+
+} // namespace vkw
+#endif // VKWRAPPER_READBACKMANAGER_HPP
@@ -5,14 +5,28 @@
 
 #include <atomic>
 #include <functional>
+#include <source_location>
+#include <utility>
+
+#ifdef VKW_REFERENCE_GUARD_TRACK_HOLDERS
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#endif
+
+#ifndef VKW_REFERENCE_GUARD_SAMPLE_RATE
+#define VKW_REFERENCE_GUARD_SAMPLE_RATE 16
+#endif
 
 namespace vkw {
 
 class ReferenceGuardError final : public Error {
 public:
-  explicit ReferenceGuardError(unsigned strongReferenceLeft) noexcept
+  explicit ReferenceGuardError(unsigned strongReferenceLeft,
+                               std::string_view holders = {}) noexcept
       : Error(std::string("Number of strong references left: ")
-                  .append(std::to_string(strongReferenceLeft))){};
+                  .append(std::to_string(strongReferenceLeft))
+                  .append(holders)){};
   std::string_view codeString() const noexcept override {
     return "Reference guard error";
   }
@@ -41,8 +55,99 @@ public:
  * is used to enable reference counter. When disabled, both
  * ReferenceGuard and StrongReference<> are empty
  *
+ * Counting policy is chosen with one of following macros (default is
+ * atomic counter):
+ *
+ * @macro VKW_REFERENCE_GUARD_THREAD_CONFINED
+ * counter is a plain integer. All strong references to an object must be
+ * created and destroyed on the same thread.
+ *
+ * @macro VKW_REFERENCE_GUARD_SAMPLED
+ * only every VKW_REFERENCE_GUARD_SAMPLE_RATE-th strong reference created by
+ * a thread is counted, others cost nothing. Dangling references are still
+ * caught, given enough of them.
+ *
+ * @macro VKW_REFERENCE_GUARD_TRACK_HOLDERS
+ * records address and creation site of every counted strong reference and
+ * lists them in the error message. Meant for debugging only.
+ *
+ * @macro VKW_COMPACT_OBJECTS
+ * with reference guard disabled, makes ReferenceGuard an empty class without
+ * virtual destructor, so it takes no space in derived objects.
+ *
+ * With reference guard enabled, ReferenceGuardImpl stays a virtual base with
+ * virtual destructor regardless of the options above. Many wrappers inherit
+ * it through several bases (e.g. Unique<> and ImageViewBase) and must share
+ * one counter, so every guarded object pays for a vtable pointer and a
+ * virtual base offset, and reaching the guard costs an indirection. Staging
+ * builds that measure wrapper overhead should take this into account.
+ *
  */
 #ifdef VKW_ENABLE_REFERENCE_GUARD
+
+namespace __detail {
+
+#ifdef VKW_REFERENCE_GUARD_THREAD_CONFINED
+class RefCounter {
+public:
+  void add() noexcept { ++m_count; }
+  void remove() noexcept { --m_count; }
+  int load() const noexcept { return m_count; }
+
+private:
+  int m_count = 0;
+};
+#else
+class RefCounter {
+public:
+  // Only removals need ordering: everything done through a reference must
+  // happen before object is checked and destroyed.
+  void add() noexcept { m_count.fetch_add(1, std::memory_order_relaxed); }
+  void remove() noexcept { m_count.fetch_sub(1, std::memory_order_release); }
+  int load() const noexcept { return m_count.load(std::memory_order_acquire); }
+
+private:
+  std::atomic<int> m_count = 0;
+};
+#endif
+
+#ifdef VKW_REFERENCE_GUARD_TRACK_HOLDERS
+class RefHolders {
+public:
+  void add(void const *holder, std::source_location location) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_holders.emplace(holder, location);
+  }
+
+  void remove(void const *holder) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_holders.erase(holder);
+  }
+
+  void move(void const *from, void const *to) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto node = m_holders.extract(from);
+    node.key() = to;
+    m_holders.insert(std::move(node));
+  }
+
+  std::string describe() const {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    std::stringstream ss;
+    for (auto const &[holder, location] : m_holders)
+      ss << "\n  held by " << holder << " created at " << location.file_name()
+         << ":" << location.line() << " (" << location.function_name() << ")";
+    return ss.str();
+  }
+
+private:
+  mutable std::mutex m_mutex;
+  std::unordered_map<void const *, std::source_location> m_holders;
+};
+#endif
+
+} // namespace __detail
+
 class ReferenceGuardImpl {
 public:
   ReferenceGuardImpl() = default;
@@ -70,25 +175,69 @@ public:
 
 private:
   friend class RefGuardInterface;
-  void add_reference() const { m_ref_count++; }
+  void add_reference([[maybe_unused]] void const *holder,
+                     [[maybe_unused]] std::source_location location) const {
+    m_ref_count.add();
+#ifdef VKW_REFERENCE_GUARD_TRACK_HOLDERS
+    m_holders.add(holder, location);
+#endif
+  }
+
+  void remove_reference([[maybe_unused]] void const *holder) const {
+#ifdef VKW_REFERENCE_GUARD_TRACK_HOLDERS
+    m_holders.remove(holder);
+#endif
+    m_ref_count.remove();
+  }
+
+  void move_reference([[maybe_unused]] void const *from,
+                      [[maybe_unused]] void const *to) const {
+#ifdef VKW_REFERENCE_GUARD_TRACK_HOLDERS
+    m_holders.move(from, to);
+#endif
+  }
 
-  void remove_reference() const { m_ref_count--; }
   void m_check_ref_count() {
-    if (m_ref_count != 0) {
-      irrecoverableError(ReferenceGuardError(m_ref_count.load()));
+    auto count = m_ref_count.load();
+    if (count != 0) {
+#ifdef VKW_REFERENCE_GUARD_TRACK_HOLDERS
+      irrecoverableError(ReferenceGuardError(count, m_holders.describe()));
+#else
+      irrecoverableError(ReferenceGuardError(count));
+#endif
     }
   }
-  mutable std::atomic<int> m_ref_count = 0;
+  mutable __detail::RefCounter m_ref_count;
+#ifdef VKW_REFERENCE_GUARD_TRACK_HOLDERS
+  mutable __detail::RefHolders m_holders;
+#endif
 };
 
 class RefGuardInterface final {
 public:
-  static void add_reference(const ReferenceGuardImpl &rg) {
-    rg.add_reference();
+  static void add_reference(const ReferenceGuardImpl &rg, void const *holder,
+                            std::source_location location) {
+    rg.add_reference(holder, location);
+  }
+
+  static void remove_reference(const ReferenceGuardImpl &rg,
+                               void const *holder) {
+    rg.remove_reference(holder);
   }
 
-  static void remove_reference(const ReferenceGuardImpl &rg) {
-    rg.remove_reference();
+  static void move_reference(const ReferenceGuardImpl &rg, void const *from,
+                             void const *to) {
+    rg.move_reference(from, to);
+  }
+
+  /// Tells if a new strong reference should be counted.
+  static bool sample() noexcept {
+#ifdef VKW_REFERENCE_GUARD_SAMPLED
+    thread_local unsigned counter = 0;
+    return counter++ % VKW_REFERENCE_GUARD_SAMPLE_RATE == 0;
+#else
+    return true;
+#endif
   }
 };
 
@@ -96,6 +245,8 @@ class ReferenceGuard : virtual public ReferenceGuardImpl {
 public:
 };
 
+#elif defined(VKW_COMPACT_OBJECTS)
+class ReferenceGuard {};
 #else
 class ReferenceGuard {
 public:
@@ -126,6 +277,10 @@ public:
  * U must be derived from T and U& must be implicitly
  * convertible to T&.
  *
+ * Counted references keep pointer to the guard itself, so that copies and
+ * destruction do not have to look up virtual base. Pointer is null for
+ * references that are moved out or not sampled.
+ *
  */
 #ifdef VKW_ENABLE_REFERENCE_GUARD
 template <typename T, typename TBase = T>
@@ -135,29 +290,36 @@ class StrongReference final : public std::reference_wrapper<T> {
 public:
   template <class U>
     requires std::derived_from<U, T>
-  StrongReference(U &object) : std::reference_wrapper<T>{object} {
-    RefGuardInterface::add_reference(static_cast<TBase &>(object));
+  StrongReference(U &object, std::source_location location =
+                                 std::source_location::current())
+      : std::reference_wrapper<T>{object}, m_guard(m_track(object)) {
+    if (m_guard)
+      RefGuardInterface::add_reference(*m_guard, this, location);
   }
 
   StrongReference(StrongReference &&another) noexcept
-      : std::reference_wrapper<T>(another) {
-    another.m_moved_out = true;
+      : std::reference_wrapper<T>(another),
+        m_guard(std::exchange(another.m_guard, nullptr)) {
+    if (m_guard)
+      RefGuardInterface::move_reference(*m_guard, &another, this);
   }
 
-  StrongReference(StrongReference const &another)
-      : std::reference_wrapper<T>(another) {
-    RefGuardInterface::add_reference(
-        static_cast<TBase &>(std::reference_wrapper<T>::get()));
+  StrongReference(
+      StrongReference const &another,
+      std::source_location location = std::source_location::current())
+      : std::reference_wrapper<T>(another), m_guard(m_track(another.get())) {
+    if (m_guard)
+      RefGuardInterface::add_reference(*m_guard, this, location);
   }
 
   StrongReference &operator=(StrongReference &&another) noexcept {
     if (this == &another)
       return *this;
-    another.m_moved_out = true;
-    RefGuardInterface::remove_reference(
-        static_cast<TBase &>(std::reference_wrapper<T>::get()));
-    std::swap(static_cast<std::reference_wrapper<T> &>(*this),
-              static_cast<std::reference_wrapper<T> &>(another));
+    m_release();
+    std::reference_wrapper<T>::operator=(another);
+    m_guard = std::exchange(another.m_guard, nullptr);
+    if (m_guard)
+      RefGuardInterface::move_reference(*m_guard, &another, this);
     return *this;
   }
 
@@ -169,15 +331,22 @@ public:
     return *this;
   }
 
-  ~StrongReference() {
-    if (m_moved_out)
-      return;
-    RefGuardInterface::remove_reference(
-        static_cast<TBase &>(std::reference_wrapper<T>::get()));
-  }
+  ~StrongReference() { m_release(); }
 
 private:
-  bool m_moved_out = false;
+  static ReferenceGuardImpl const *m_track(T &object) noexcept {
+    if (!RefGuardInterface::sample())
+      return nullptr;
+    return &static_cast<ReferenceGuardImpl const &>(
+        static_cast<TBase const &>(object));
+  }
+
+  void m_release() noexcept {
+    if (m_guard)
+      RefGuardInterface::remove_reference(*m_guard, this);
+  }
+
+  ReferenceGuardImpl const *m_guard;
 };
 #else
 
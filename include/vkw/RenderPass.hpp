@@ -3,6 +3,7 @@
 
 #include <vkw/Containers.hpp>
 #include <vkw/Device.hpp>
+#include <vkw/Format.hpp>
 #include <vkw/RangeConcepts.hpp>
 
 #include <algorithm>
@@ -35,42 +36,13 @@ public:
   VkFormat format() const noexcept { return VkAttachmentDescription::format; }
 
   bool isDepthStencil() const noexcept {
-    switch (format()) {
-    case VK_FORMAT_D32_SFLOAT_S8_UINT:
-    case VK_FORMAT_D32_SFLOAT:
-    case VK_FORMAT_D16_UNORM:
-    case VK_FORMAT_D16_UNORM_S8_UINT:
-    case VK_FORMAT_D24_UNORM_S8_UINT:
-    case VK_FORMAT_X8_D24_UNORM_PACK32:
-    case VK_FORMAT_S8_UINT:
-      return true;
-    default:
-      return false;
-    }
+    return formatInfo(format()).isDepthStencil();
   }
   bool formatHasDepthAspect() const noexcept {
-    switch (format()) {
-    case VK_FORMAT_D32_SFLOAT_S8_UINT:
-    case VK_FORMAT_D32_SFLOAT:
-    case VK_FORMAT_D16_UNORM:
-    case VK_FORMAT_D16_UNORM_S8_UINT:
-    case VK_FORMAT_D24_UNORM_S8_UINT:
-    case VK_FORMAT_X8_D24_UNORM_PACK32:
-      return true;
-    default:
-      return false;
-    }
+    return formatInfo(format()).hasDepth();
   }
   bool formatHasStencilAspect() const noexcept {
-    switch (format()) {
-    case VK_FORMAT_D32_SFLOAT_S8_UINT:
-    case VK_FORMAT_D16_UNORM_S8_UINT:
-    case VK_FORMAT_D24_UNORM_S8_UINT:
-    case VK_FORMAT_S8_UINT:
-      return true;
-    default:
-      return false;
-    }
+    return formatInfo(format()).hasStencil();
   }
   bool isColor() const noexcept { return !isDepthStencil(); }
 
@@ -0,0 +1,555 @@
+#ifndef VKWRAPPER_RENDERQUEUE_HPP
+#define VKWRAPPER_RENDERQUEUE_HPP
+
+#include <vkw/CommandRecorder.hpp>
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace vkw {
+
+/**
+ * @class DrawPacket
+ *
+ * complete state of one draw. Only raw handles are stored, so objects
+ * referenced by packet must stay alive until it is emitted.
+ */
+struct DrawPacket {
+  static constexpr uint32_t MaxDescriptorSets = 4;
+  static constexpr uint32_t MaxDynamicOffsets = 8;
+  // Guaranteed minimum of maxPushConstantsSize.
+  static constexpr uint32_t MaxPushConstantSize = 128;
+  static constexpr uint32_t MaxInstanceDataSize = 64;
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  VkPipelineLayout layout = VK_NULL_HANDLE;
+
+  uint32_t descriptorSetCount = 0;
+  uint32_t dynamicOffsetCount = 0;
+  std::array<VkDescriptorSet, MaxDescriptorSets> descriptorSets{};
+  std::array<uint32_t, MaxDynamicOffsets> dynamicOffsets{};
+
+  VkBuffer vertexBuffer = VK_NULL_HANDLE;
+  VkDeviceSize vertexBufferOffset = 0;
+  // Non-indexed draw if index buffer is null.
+  VkBuffer indexBuffer = VK_NULL_HANDLE;
+  VkDeviceSize indexBufferOffset = 0;
+  VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+
+  VkShaderStageFlags pushConstantStages = 0;
+  uint32_t pushConstantSize = 0;
+  std::array<unsigned char, MaxPushConstantSize> pushConstants{};
+
+  // Vertex or index count.
+  uint32_t count = 0;
+  uint32_t instanceCount = 1;
+  // First vertex or first index.
+  uint32_t first = 0;
+  int32_t vertexOffset = 0;
+  uint32_t firstInstance = 0;
+
+  // Per instance data, see RenderQueue::emit().
+  uint32_t instanceDataSize = 0;
+  std::array<unsigned char, MaxInstanceDataSize> instanceData{};
+
+  // Lowest bits of sort key, e.g. quantized depth. Orders packets that
+  // share all other state, only 12 highest bits are used.
+  uint16_t order = 0;
+
+  DrawPacket() = default;
+
+  explicit DrawPacket(GraphicsPipeline const &graphicsPipeline) noexcept
+      : pipeline(graphicsPipeline), layout(graphicsPipeline.layout()) {}
+
+  /// Appends set to sets bound starting from set 0, with its dynamic offsets.
+  void addDescriptorSet(DescriptorSet const &set) noexcept(ExceptionsDisabled) {
+    assert(descriptorSetCount < MaxDescriptorSets && "too many sets");
+    descriptorSets[descriptorSetCount++] = set;
+    for (auto const &offset : set.dynamicOffsets()) {
+      assert(dynamicOffsetCount < MaxDynamicOffsets &&
+             "too many dynamic offsets");
+      dynamicOffsets[dynamicOffsetCount++] = offset.offset;
+    }
+  }
+
+  template <typename T>
+  void setVertexBuffer(VertexBuffer<T> const &buffer,
+                       VkDeviceSize offset = 0) noexcept {
+    vertexBuffer = buffer;
+    vertexBufferOffset = offset;
+  }
+
+  template <VkIndexType type>
+  void setIndexBuffer(IndexBuffer<type> const &buffer,
+                      VkDeviceSize offset = 0) noexcept {
+    indexBuffer = buffer;
+    indexBufferOffset = offset;
+    indexType = type;
+  }
+
+  template <typename T>
+  void setPushConstants(VkShaderStageFlags stages, T const &value) noexcept {
+    static_assert(std::is_trivially_copyable_v<T> &&
+                  sizeof(T) <= MaxPushConstantSize);
+    pushConstantStages = stages;
+    pushConstantSize = sizeof(T);
+    std::memcpy(pushConstants.data(), &value, sizeof(T));
+  }
+
+  void setDraw(uint32_t vertexCount, uint32_t instances = 1,
+               uint32_t firstVertex = 0, uint32_t firstInst = 0) noexcept {
+    count = vertexCount;
+    instanceCount = instances;
+    first = firstVertex;
+    firstInstance = firstInst;
+  }
+
+  void setDrawIndexed(uint32_t indexCount, uint32_t instances = 1,
+                      uint32_t firstIndex = 0, int32_t vertexOff = 0,
+                      uint32_t firstInst = 0) noexcept {
+    count = indexCount;
+    instanceCount = instances;
+    first = firstIndex;
+    vertexOffset = vertexOff;
+    firstInstance = firstInst;
+  }
+
+  /**
+   * Makes packet a single instance whose data is written to instance buffer
+   * on emit, so that it can be merged with identical draws.
+   */
+  template <typename T> void setInstanceData(T const &value) noexcept {
+    static_assert(std::is_trivially_copyable_v<T> &&
+                  sizeof(T) <= MaxInstanceDataSize);
+    instanceCount = 1;
+    firstInstance = 0;
+    instanceDataSize = sizeof(T);
+    std::memcpy(instanceData.data(), &value, sizeof(T));
+  }
+
+  std::span<const VkDescriptorSet> sets() const noexcept {
+    return {descriptorSets.data(), descriptorSetCount};
+  }
+
+  std::span<const uint32_t> offsets() const noexcept {
+    return {dynamicOffsets.data(), dynamicOffsetCount};
+  }
+
+  std::span<const unsigned char> pushConstantData() const noexcept {
+    return {pushConstants.data(), pushConstantSize};
+  }
+};
+
+namespace __detail {
+
+struct SortEntry {
+  uint64_t key;
+  uint32_t index;
+};
+
+/**
+ * LSD radix sort of entries by key with 8 bit digits. Stable. Passes where
+ * every key has the same digit are skipped. Work of each pass is split
+ * between threadCount threads including the calling one.
+ */
+inline void m_radixSort(std::vector<SortEntry> &entries,
+                        std::vector<SortEntry> &scratch,
+                        unsigned threadCount) noexcept(ExceptionsDisabled) {
+  constexpr unsigned digitBits = 8;
+  constexpr unsigned digits = 1u << digitBits;
+  constexpr unsigned passes = 64 / digitBits;
+
+  auto size = entries.size();
+  scratch.resize(size);
+  threadCount = std::max(1u, threadCount);
+  std::vector<std::array<size_t, digits>> histograms(threadCount);
+  std::barrier sync(threadCount);
+
+  auto *src = &entries;
+  auto *dst = &scratch;
+
+  auto work = [&](unsigned thread) {
+    auto begin = size * thread / threadCount;
+    auto end = size * (thread + 1) / threadCount;
+    for (unsigned pass = 0; pass < passes; ++pass) {
+      auto shift = pass * digitBits;
+      auto &histogram = histograms[thread];
+      histogram.fill(0);
+      for (auto i = begin; i < end; ++i)
+        ++histogram[((*src)[i].key >> shift) & (digits - 1)];
+      sync.arrive_and_wait();
+
+      // Every thread computes the same totals, so all of them agree on
+      // whether the pass is skipped.
+      std::array<size_t, digits> offsets{};
+      bool trivial = false;
+      size_t position = 0;
+      for (unsigned digit = 0; digit < digits; ++digit) {
+        size_t total = 0;
+        for (unsigned t = 0; t < threadCount; ++t) {
+          if (t == thread)
+            offsets[digit] = position + total;
+          total += histograms[t][digit];
+        }
+        trivial = trivial || total == size;
+        position += total;
+      }
+
+      if (!trivial)
+        for (auto i = begin; i < end; ++i) {
+          auto digit = ((*src)[i].key >> shift) & (digits - 1);
+          (*dst)[offsets[digit]++] = (*src)[i];
+        }
+      sync.arrive_and_wait();
+
+      if (!trivial && thread == 0)
+        std::swap(src, dst);
+      sync.arrive_and_wait();
+    }
+  };
+
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(threadCount - 1);
+    for (unsigned t = 1; t < threadCount; ++t)
+      workers.emplace_back(work, t);
+    work(0);
+  }
+
+  if (src != &entries)
+    std::swap(entries, scratch);
+}
+
+// Dense ids of values in order of first appearance, saturated at limit.
+template <typename T> struct HandleIds {
+  uint16_t get(T const &value, uint16_t limit) {
+    auto [found, inserted] = ids.try_emplace(value, next);
+    if (inserted && next != limit)
+      ++next;
+    return found->second;
+  }
+
+  void clear() noexcept {
+    ids.clear();
+    next = 0;
+  }
+
+  struct Hash {
+    size_t operator()(T const &value) const noexcept {
+      if constexpr (!std::ranges::range<T>) {
+        return std::hash<T>{}(value);
+      } else {
+        size_t seed = 0;
+        for (auto const &handle : value)
+          seed ^= std::hash<std::remove_cvref_t<decltype(handle)>>{}(handle) +
+                  0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+      }
+    }
+  };
+
+  std::unordered_map<T, uint16_t, Hash> ids;
+  uint16_t next = 0;
+};
+
+} // namespace __detail
+
+/**
+ * @class RenderQueue
+ *
+ * collects draw packets from many threads, sorts them by state and records
+ * them with minimal state changes.
+ *
+ * Each recording thread obtains its own Writer, writers append without
+ * locking. Writers obtained on the same thread share one packet bucket, so
+ * a writer must only be used on the thread that obtained it and the number
+ * of buckets is bounded by the number of recording threads. emit() must be
+ * called when no writer is in use. It packs state
+ * of every packet into 64 bit key (from highest to lowest bits: pipeline
+ * 14, descriptor sets 14, vertex and index buffers 12, mesh range 12, order
+ * 12), sorts keys with parallel radix sort and records packets skipping
+ * binds of state that is already bound.
+ *
+ * State is mapped to dense ids in order of first appearance, so keys only
+ * group equal state together. Ids saturate when a field runs out of bits
+ * which degrades grouping but not correctness: emitted state is always
+ * compared by handle.
+ *
+ * Consecutive packets with instance data and otherwise identical state are
+ * merged into one instanced draw when emit() is given an instance buffer.
+ */
+class RenderQueue {
+public:
+  class Writer {
+  public:
+    void submit(DrawPacket const &packet) { m_packets->push_back(packet); }
+
+  private:
+    friend class RenderQueue;
+    explicit Writer(std::vector<DrawPacket> &packets) noexcept
+        : m_packets(&packets) {}
+
+    std::vector<DrawPacket> *m_packets;
+  };
+
+  /// Bind and draw counts of the last emit() call.
+  struct Statistics {
+    uint32_t draws = 0;
+    uint32_t pipelineBinds = 0;
+    uint32_t descriptorSetBinds = 0;
+    uint32_t vertexBufferBinds = 0;
+    uint32_t indexBufferBinds = 0;
+    uint32_t pushConstantUpdates = 0;
+    // Packets drawn as a part of instanced draws.
+    uint32_t instancedPackets = 0;
+  };
+
+  /**
+   * sortThreads is upper limit of threads used by sort, 0 means hardware
+   * concurrency.
+   */
+  explicit RenderQueue(unsigned sortThreads = 0) noexcept
+      : m_sortThreads(sortThreads ? sortThreads
+                                  : std::thread::hardware_concurrency()) {}
+
+  /**
+   * Returns writer of the calling thread's bucket. Writer stays valid for
+   * the lifetime of the queue, but must not leave the calling thread.
+   */
+  Writer writer() {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto &bucket = m_threadBuckets[std::this_thread::get_id()];
+    if (!bucket) {
+      m_buckets.push_back(std::make_unique<std::vector<DrawPacket>>());
+      bucket = m_buckets.back().get();
+    }
+    return Writer{*bucket};
+  }
+
+  /// Sorts and records all submitted packets, then clears the queue.
+  Statistics emit(RenderPassRecorder &recorder) noexcept(ExceptionsDisabled) {
+    return m_emit(recorder, nullptr, 0, {});
+  }
+
+  /**
+   * Same as emit(recorder), but also merges packets with instance data.
+   * Instance data of merged packets is written consecutively to mapped
+   * instanceBuffer with instanceStride and the draw gets firstInstance of
+   * the first one, so shaders fetch it with per_instance vertex binding or
+   * from storage buffer by gl_InstanceIndex. If instanceBinding is set
+   * instanceBuffer is bound to it as vertex buffer, it must not be 0 which
+   * packet vertex buffers are bound to.
+   *
+   * Every packet with instance data must have instanceDataSize equal to
+   * instanceStride and draw a single instance. Buffer must hold an element
+   * for each such packet.
+   */
+  Statistics
+  emit(RenderPassRecorder &recorder, BufferBase &instanceBuffer,
+       uint32_t instanceStride,
+       std::optional<uint32_t> instanceBinding = {}) noexcept(
+      ExceptionsDisabled) {
+    return m_emit(recorder, &instanceBuffer, instanceStride, instanceBinding);
+  }
+
+private:
+  Statistics m_emit(RenderPassRecorder &recorder, BufferBase *instanceBuffer,
+                    uint32_t instanceStride,
+                    std::optional<uint32_t> instanceBinding) noexcept(
+      ExceptionsDisabled) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_buildKeys();
+
+    // Threads only pay off on large queues.
+    constexpr size_t entriesPerThread = 16384;
+    auto threads = static_cast<unsigned>(std::clamp<size_t>(
+        m_entries.size() / entriesPerThread, 1, std::max(1u, m_sortThreads)));
+    __detail::m_radixSort(m_entries, m_scratch, threads);
+
+    std::span<unsigned char> instances;
+    if (instanceBuffer) {
+      instances = instanceBuffer->mapped<unsigned char>();
+      assert(!instances.empty() && "instance buffer is not mapped");
+      assert(instanceBinding != 0u &&
+             "binding 0 is used by packet vertex buffers");
+      if (instanceBinding)
+        recorder.bindVertexBuffer(*instanceBuffer, *instanceBinding, 0);
+    }
+
+    Statistics stats{};
+    uint32_t instanceCount = 0;
+    DrawPacket const *bound = nullptr;
+    for (auto entry = m_entries.begin(); entry != m_entries.end();) {
+      auto const &packet = *m_packets[entry->index];
+      auto next = std::next(entry);
+
+      if (!instanceBuffer || packet.instanceDataSize == 0) {
+        m_record(recorder, packet, bound, packet.instanceCount,
+                 packet.firstInstance, stats);
+        bound = &packet;
+        entry = next;
+        continue;
+      }
+
+      assert(packet.instanceDataSize == instanceStride &&
+             "instance data size does not match stride");
+      assert(packet.instanceCount == 1 && packet.firstInstance == 0 &&
+             "packet with instance data must draw a single instance");
+      while (next != m_entries.end() &&
+             m_sameDraw(packet, *m_packets[next->index]))
+        ++next;
+
+      auto firstInstance = instanceCount;
+      for (; entry != next; ++entry) {
+        assert((instanceCount + 1) * instanceStride <= instances.size() &&
+               "instance buffer is too small");
+        std::memcpy(instances.data() + instanceCount * instanceStride,
+                    m_packets[entry->index]->instanceData.data(),
+                    instanceStride);
+        ++instanceCount;
+      }
+      auto mergedCount = instanceCount - firstInstance;
+      m_record(recorder, packet, bound, mergedCount, firstInstance, stats);
+      if (mergedCount > 1)
+        stats.instancedPackets += mergedCount;
+      bound = &packet;
+    }
+
+    if (instanceCount)
+      instanceBuffer->flush(0, instanceCount * instanceStride);
+
+    for (auto &bucket : m_buckets)
+      bucket->clear();
+    m_packets.clear();
+    m_entries.clear();
+    return stats;
+  }
+
+  void m_buildKeys() {
+    m_pipelineIds.clear();
+    m_setIds.clear();
+    m_geometryIds.clear();
+    m_meshIds.clear();
+    m_packets.clear();
+    m_entries.clear();
+
+    for (auto const &bucket : m_buckets)
+      for (auto const &packet : *bucket) {
+        uint64_t pipeline = m_pipelineIds.get(packet.pipeline, 0x3FFF);
+        uint64_t sets = m_setIds.get(packet.descriptorSets, 0x3FFF);
+        uint64_t geometry = m_geometryIds.get(
+            {packet.vertexBuffer, packet.indexBuffer}, 0xFFF);
+        uint64_t mesh = m_meshIds.get(
+            {packet.vertexBufferOffset, packet.indexBufferOffset,
+             uint64_t(packet.count) << 32u | packet.first,
+             static_cast<uint32_t>(packet.vertexOffset)},
+            0xFFF);
+        m_entries.push_back(__detail::SortEntry{
+            pipeline << 50u | sets << 36u | geometry << 24u | mesh << 12u |
+                packet.order >> 4u,
+            static_cast<uint32_t>(m_packets.size())});
+        m_packets.push_back(&packet);
+      }
+  }
+
+  // True if packets differ only in instance data, order and firstInstance.
+  static bool m_sameDraw(DrawPacket const &lhs,
+                         DrawPacket const &rhs) noexcept {
+    return lhs.instanceDataSize == rhs.instanceDataSize &&
+           lhs.pipeline == rhs.pipeline && lhs.layout == rhs.layout &&
+           std::ranges::equal(lhs.sets(), rhs.sets()) &&
+           std::ranges::equal(lhs.offsets(), rhs.offsets()) &&
+           lhs.pushConstantStages == rhs.pushConstantStages &&
+           std::ranges::equal(lhs.pushConstantData(),
+                              rhs.pushConstantData()) &&
+           lhs.vertexBuffer == rhs.vertexBuffer &&
+           lhs.vertexBufferOffset == rhs.vertexBufferOffset &&
+           lhs.indexBuffer == rhs.indexBuffer &&
+           lhs.indexBufferOffset == rhs.indexBufferOffset &&
+           lhs.indexType == rhs.indexType && lhs.count == rhs.count &&
+           lhs.first == rhs.first && lhs.vertexOffset == rhs.vertexOffset;
+  }
+
+  static void m_record(RenderPassRecorder &recorder, DrawPacket const &packet,
+                       DrawPacket const *bound, uint32_t instanceCount,
+                       uint32_t firstInstance, Statistics &stats) noexcept {
+    if (!bound || bound->pipeline != packet.pipeline) {
+      recorder.bindPipeline(packet.pipeline);
+      ++stats.pipelineBinds;
+    }
+
+    // Sets and push constants stay valid while layout is the same.
+    bool layoutChanged = !bound || bound->layout != packet.layout;
+    if (packet.descriptorSetCount &&
+        (layoutChanged || !std::ranges::equal(bound->sets(), packet.sets()) ||
+         !std::ranges::equal(bound->offsets(), packet.offsets()))) {
+      recorder.bindDescriptorSets(packet.layout,
+                                  VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                  packet.sets(), 0, packet.offsets());
+      ++stats.descriptorSetBinds;
+    }
+
+    if (packet.pushConstantSize &&
+        (layoutChanged ||
+         bound->pushConstantStages != packet.pushConstantStages ||
+         !std::ranges::equal(bound->pushConstantData(),
+                             packet.pushConstantData()))) {
+      recorder.pushConstants(packet.layout, packet.pushConstantStages, 0,
+                             packet.pushConstantData());
+      ++stats.pushConstantUpdates;
+    }
+
+    if (packet.vertexBuffer &&
+        (!bound || bound->vertexBuffer != packet.vertexBuffer ||
+         bound->vertexBufferOffset != packet.vertexBufferOffset)) {
+      recorder.bindVertexBuffer(packet.vertexBuffer, 0,
+                                packet.vertexBufferOffset);
+      ++stats.vertexBufferBinds;
+    }
+
+    if (packet.indexBuffer &&
+        (!bound || bound->indexBuffer != packet.indexBuffer ||
+         bound->indexBufferOffset != packet.indexBufferOffset ||
+         bound->indexType != packet.indexType)) {
+      recorder.bindIndexBuffer(packet.indexBuffer, packet.indexBufferOffset,
+                               packet.indexType);
+      ++stats.indexBufferBinds;
+    }
+
+    if (packet.indexBuffer)
+      recorder.drawIndexed(packet.count, instanceCount, packet.first,
+                           packet.vertexOffset, firstInstance);
+    else
+      recorder.draw(packet.count, instanceCount, packet.first, firstInstance);
+    ++stats.draws;
+  }
+
+  unsigned m_sortThreads;
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<std::vector<DrawPacket>>> m_buckets;
+  std::unordered_map<std::thread::id, std::vector<DrawPacket> *>
+      m_threadBuckets;
+  std::vector<DrawPacket const *> m_packets;
+  std::vector<__detail::SortEntry> m_entries;
+  std::vector<__detail::SortEntry> m_scratch;
+  __detail::HandleIds<VkPipeline> m_pipelineIds;
+  using DescriptorSets =
+      std::array<VkDescriptorSet, DrawPacket::MaxDescriptorSets>;
+
+  __detail::HandleIds<DescriptorSets> m_setIds;
+  __detail::HandleIds<std::array<VkBuffer, 2>> m_geometryIds;
+  __detail::HandleIds<std::array<uint64_t, 4>> m_meshIds;
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_RENDERQUEUE_HPP
@@ -0,0 +1,417 @@
+#ifndef VKWRAPPER_RESOURCEREGISTRY_HPP
+#define VKWRAPPER_RESOURCEREGISTRY_HPP
+
+#include <vkw/Buffer.hpp>
+#include <vkw/Image.hpp>
+#include <vkw/Sampler.hpp>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace vkw {
+
+/**
+ * @class ResourceHandle
+ *
+ * is a 32-bit reference to resource in ResourceRegistry: 24 bits of slot
+ * index and 8 bits of slot generation. Generation changes every time slot is
+ * reused, so handles of removed resources do not resolve to new ones (until
+ * generation wraps around after 255 reuses of the same slot). Zero handle is
+ * never valid.
+ *
+ * @tparam Tag distinguishes handles of different resource kinds.
+ */
+template <typename Tag> class ResourceHandle {
+public:
+  static constexpr uint32_t IndexBits = 24;
+  static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+  static constexpr uint32_t GenerationMask = 0xFF;
+
+  ResourceHandle() noexcept = default;
+
+  explicit ResourceHandle(uint32_t value) noexcept : m_value(value) {}
+
+  uint32_t value() const noexcept { return m_value; }
+
+  uint32_t index() const noexcept { return m_value & IndexMask; }
+
+  uint32_t generation() const noexcept { return m_value >> IndexBits; }
+
+  explicit operator bool() const noexcept { return m_value != 0; }
+
+  bool operator==(ResourceHandle const &another) const noexcept = default;
+
+private:
+  uint32_t m_value = 0;
+};
+
+using BufferHandle = ResourceHandle<BufferBase>;
+using ImageHandle = ResourceHandle<ImageInterface>;
+using ImageViewHandle = ResourceHandle<ImageViewBase>;
+using SamplerHandle = ResourceHandle<Sampler>;
+
+namespace __detail {
+
+/// Owns wrapper object of any type, remembers the type for checked access.
+class ErasedOwner {
+public:
+  ErasedOwner() noexcept = default;
+
+  template <typename T>
+  explicit ErasedOwner(std::unique_ptr<T> object) noexcept
+      : m_object(object.release(),
+                 [](void *ptr) { delete static_cast<T *>(ptr); }),
+        m_type(&typeTag<T>) {}
+
+  template <typename T> T *get() const noexcept {
+    assert(m_type == &typeTag<T> && "object is of different type");
+    return static_cast<T *>(m_object.get());
+  }
+
+private:
+  template <typename T> static constexpr char typeTag = 0;
+
+  std::unique_ptr<void, void (*)(void *)> m_object{nullptr, nullptr};
+  void const *m_type = nullptr;
+};
+
+/**
+ * Structure of arrays table with generational slots. Every column is stored
+ * in pages of PageSize contiguous elements. Pages are never moved or freed
+ * while table is alive, so lookups do not lock: they check generation of the
+ * slot and read columns in place. Insertion and removal are serialized by a
+ * mutex.
+ *
+ * Columns of a removed slot are only overwritten when slot is reused, still
+ * removal must not race with readers of the same handle (i.e. resources are
+ * removed after the device and other threads are done with them).
+ */
+template <typename Tag, typename... Columns> class SoATable {
+public:
+  using Handle = ResourceHandle<Tag>;
+
+  static constexpr uint32_t PageBits = 10;
+  static constexpr uint32_t PageSize = 1u << PageBits;
+  static constexpr uint32_t MaxPages = 1u << (Handle::IndexBits - PageBits);
+
+  SoATable() : m_pages(std::make_unique<std::atomic<Page *>[]>(MaxPages)) {}
+
+  SoATable(SoATable const &) = delete;
+  SoATable &operator=(SoATable const &) = delete;
+
+  ~SoATable() {
+    for (uint32_t i = 0; i < MaxPages; ++i)
+      delete m_pages[i].load(std::memory_order_relaxed);
+  }
+
+  /// Returns null handle if table is full.
+  Handle insert(Columns... values) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    uint32_t index;
+    if (!m_free.empty()) {
+      index = m_free.back();
+      m_free.pop_back();
+    } else {
+      index = m_size.load(std::memory_order_relaxed);
+      if (index == MaxPages * PageSize)
+        return Handle{};
+      if (index % PageSize == 0)
+        m_pages[index / PageSize].store(new Page{}, std::memory_order_release);
+      m_size.store(index + 1, std::memory_order_release);
+    }
+
+    auto &page = *m_pages[index / PageSize].load(std::memory_order_relaxed);
+    auto slot = index % PageSize;
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+      ((std::get<Is>(page.columns)[slot] = std::move(values)), ...);
+    }(std::index_sequence_for<Columns...>{});
+
+    uint32_t generation =
+        (page.states[slot].load(std::memory_order_relaxed) >> 1) %
+            Handle::GenerationMask +
+        1;
+    page.states[slot].store(generation << 1 | 1, std::memory_order_release);
+    return Handle{generation << Handle::IndexBits | index};
+  }
+
+  /// Removes slot and resets its columns. Returns false if handle is stale.
+  bool remove(Handle handle) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto *page = m_locate(handle);
+    if (!page)
+      return false;
+    auto slot = handle.index() % PageSize;
+    page->states[slot].store(handle.generation() << 1,
+                             std::memory_order_release);
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+      ((std::get<Is>(page->columns)[slot] = Columns{}), ...);
+    }(std::index_sequence_for<Columns...>{});
+    m_free.push_back(handle.index());
+    return true;
+  }
+
+  bool contains(Handle handle) const noexcept {
+    return m_locate(handle) != nullptr;
+  }
+
+  /// Element of column for handle, null if handle is stale.
+  template <size_t column>
+  auto *find(Handle handle) const noexcept {
+    using T = std::tuple_element_t<column, std::tuple<Columns...>>;
+    auto *page = m_locate(handle);
+    if (!page)
+      return static_cast<T *>(nullptr);
+    return &std::get<column>(page->columns)[handle.index() % PageSize];
+  }
+
+  /**
+   * Calls fn(handle, columns...) for each live slot with elements of
+   * selected columns. Only selected columns are read, page by page.
+   */
+  template <size_t... columns, typename Fn> void forEach(Fn &&fn) const {
+    auto size = m_size.load(std::memory_order_acquire);
+    for (uint32_t first = 0; first < size; first += PageSize) {
+      auto &page = *m_pages[first / PageSize].load(std::memory_order_acquire);
+      auto count = std::min(PageSize, size - first);
+      for (uint32_t slot = 0; slot < count; ++slot) {
+        auto state = page.states[slot].load(std::memory_order_acquire);
+        if (!(state & 1))
+          continue;
+        fn(Handle{(state >> 1) << Handle::IndexBits | (first + slot)},
+           std::get<columns>(page.columns)[slot]...);
+      }
+    }
+  }
+
+  /// Number of live slots.
+  uint32_t size() const noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_size.load(std::memory_order_relaxed) - m_free.size();
+  }
+
+private:
+  struct Page {
+    std::tuple<std::array<Columns, PageSize>...> columns;
+    // generation << 1 | alive
+    std::array<std::atomic<uint32_t>, PageSize> states;
+  };
+
+  Page *m_locate(Handle handle) const noexcept {
+    if (!handle || handle.index() >= m_size.load(std::memory_order_acquire))
+      return nullptr;
+    auto *page =
+        m_pages[handle.index() / PageSize].load(std::memory_order_acquire);
+    auto state =
+        page->states[handle.index() % PageSize].load(std::memory_order_acquire);
+    return state == (handle.generation() << 1 | 1) ? page : nullptr;
+  }
+
+  std::unique_ptr<std::atomic<Page *>[]> m_pages;
+  std::atomic<uint32_t> m_size = 0;
+  mutable std::mutex m_mutex;
+  std::vector<uint32_t> m_free;
+};
+
+} // namespace __detail
+
+/**
+ * @class ResourceRegistry
+ *
+ * optionally owns buffers, images, image views and samplers and keeps data
+ * needed by bulk operations (barrier generation, residency scans, descriptor
+ * writes) in structure of arrays tables addressed by 32-bit generational
+ * handles. Such passes read only the columns they need from contiguous
+ * memory instead of visiting every wrapper object.
+ *
+ * Lookups are lock-free and may run concurrently with insertions, see
+ * __detail::SoATable for the rules of removal. setLayout() is not
+ * synchronized with readers of the same image.
+ *
+ * e.g.:
+ *    ResourceRegistry registry;
+ *    auto handle = registry.add(std::make_unique<Buffer<float>>(...));
+ *    registry.forEachBuffer([&](BufferHandle, VkBuffer buffer,
+ *                               VkDeviceSize size, VkBufferUsageFlags,
+ *                               VkDeviceAddress) { ... });
+ */
+class ResourceRegistry {
+public:
+  template <std::derived_from<BufferBase> T>
+  BufferHandle add(std::unique_ptr<T> buffer) {
+    assert(buffer && "registering null buffer");
+    VkDeviceAddress address = 0;
+#ifdef VK_VERSION_1_2
+    address = buffer->deviceAddress();
+#endif
+    VkBuffer handle = *buffer;
+    auto size = buffer->bufferSize();
+    auto usage = buffer->usage();
+    return m_buffers.insert(handle, size, usage, address,
+                            __detail::ErasedOwner{std::move(buffer)});
+  }
+
+  /// layout is the current layout of the image, see setLayout().
+  template <std::derived_from<ImageInterface> T>
+  ImageHandle add(std::unique_ptr<T> image,
+                  VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED) {
+    assert(image && "registering null image");
+    VkImage handle = *image;
+    auto format = image->format();
+    auto extent = image->rawExtents();
+    auto range = image->completeSubresourceRange();
+    auto usage = image->usage();
+    return m_images.insert(handle, format, extent, range, usage, layout,
+                           __detail::ErasedOwner{std::move(image)});
+  }
+
+  /// image is the handle view was created from, if it is registered.
+  template <std::derived_from<ImageViewBase> T>
+  ImageViewHandle add(std::unique_ptr<T> view, ImageHandle image = {}) {
+    assert(view && "registering null image view");
+    VkImageView handle = *view;
+    auto format = view->format();
+    auto range = view->subresourceRange();
+    return m_views.insert(handle, image, format, range,
+                          __detail::ErasedOwner{std::move(view)});
+  }
+
+  template <std::derived_from<Sampler> T>
+  SamplerHandle add(std::unique_ptr<T> sampler) {
+    assert(sampler && "registering null sampler");
+    VkSampler handle = *sampler;
+    return m_samplers.insert(handle,
+                             __detail::ErasedOwner{std::move(sampler)});
+  }
+
+  /// Destroys resource. Returns false if handle is stale.
+  bool remove(BufferHandle handle) { return m_buffers.remove(handle); }
+  bool remove(ImageHandle handle) { return m_images.remove(handle); }
+  bool remove(ImageViewHandle handle) { return m_views.remove(handle); }
+  bool remove(SamplerHandle handle) { return m_samplers.remove(handle); }
+
+  /** Lookup. Stale handles give VK_NULL_HANDLE or nullopt. **/
+
+  VkBuffer buffer(BufferHandle handle) const noexcept {
+    auto *found = m_buffers.find<BufferColumn::Handle>(handle);
+    return found ? *found : VK_NULL_HANDLE;
+  }
+
+  VkImage image(ImageHandle handle) const noexcept {
+    auto *found = m_images.find<ImageColumn::Handle>(handle);
+    return found ? *found : VK_NULL_HANDLE;
+  }
+
+  VkImageView view(ImageViewHandle handle) const noexcept {
+    auto *found = m_views.find<ViewColumn::Handle>(handle);
+    return found ? *found : VK_NULL_HANDLE;
+  }
+
+  VkSampler sampler(SamplerHandle handle) const noexcept {
+    auto *found = m_samplers.find<SamplerColumn::Handle>(handle);
+    return found ? *found : VK_NULL_HANDLE;
+  }
+
+  std::optional<VkImageLayout> layout(ImageHandle handle) const noexcept {
+    auto *found = m_images.find<ImageColumn::Layout>(handle);
+    return found ? std::optional{*found} : std::nullopt;
+  }
+
+  /// Records layout image is in after last recorded barrier.
+  bool setLayout(ImageHandle handle, VkImageLayout layout) noexcept {
+    auto *found = m_images.find<ImageColumn::Layout>(handle);
+    if (!found)
+      return false;
+    *found = layout;
+    return true;
+  }
+
+  /// Wrapper object of resource. T must be the exact type it was added as.
+  template <typename T, typename Tag>
+  T *object(ResourceHandle<Tag> handle) const noexcept {
+    __detail::ErasedOwner const *owner = nullptr;
+    if constexpr (std::same_as<Tag, BufferBase>)
+      owner = m_buffers.find<BufferColumn::Owner>(handle);
+    else if constexpr (std::same_as<Tag, ImageInterface>)
+      owner = m_images.find<ImageColumn::Owner>(handle);
+    else if constexpr (std::same_as<Tag, ImageViewBase>)
+      owner = m_views.find<ViewColumn::Owner>(handle);
+    else
+      owner = m_samplers.find<SamplerColumn::Owner>(handle);
+    return owner ? owner->get<T>() : nullptr;
+  }
+
+  /** Bulk iteration **/
+
+  /// fn(BufferHandle, VkBuffer, VkDeviceSize size, VkBufferUsageFlags,
+  ///    VkDeviceAddress)
+  template <typename Fn> void forEachBuffer(Fn &&fn) const {
+    m_buffers.forEach<BufferColumn::Handle, BufferColumn::Size,
+                      BufferColumn::Usage, BufferColumn::Address>(
+        std::forward<Fn>(fn));
+  }
+
+  /// fn(ImageHandle, VkImage, VkFormat, VkExtent3D,
+  ///    VkImageSubresourceRange const &, VkImageUsageFlags, VkImageLayout)
+  template <typename Fn> void forEachImage(Fn &&fn) const {
+    m_images.forEach<ImageColumn::Handle, ImageColumn::Format,
+                     ImageColumn::Extent, ImageColumn::Range,
+                     ImageColumn::Usage, ImageColumn::Layout>(
+        std::forward<Fn>(fn));
+  }
+
+  /// fn(ImageViewHandle, VkImageView, ImageHandle, VkFormat,
+  ///    VkImageSubresourceRange const &)
+  template <typename Fn> void forEachView(Fn &&fn) const {
+    m_views.forEach<ViewColumn::Handle, ViewColumn::Image, ViewColumn::Format,
+                    ViewColumn::Range>(std::forward<Fn>(fn));
+  }
+
+  /// fn(SamplerHandle, VkSampler)
+  template <typename Fn> void forEachSampler(Fn &&fn) const {
+    m_samplers.forEach<SamplerColumn::Handle>(std::forward<Fn>(fn));
+  }
+
+  uint32_t bufferCount() const noexcept { return m_buffers.size(); }
+  uint32_t imageCount() const noexcept { return m_images.size(); }
+  uint32_t viewCount() const noexcept { return m_views.size(); }
+  uint32_t samplerCount() const noexcept { return m_samplers.size(); }
+
+private:
+  struct BufferColumn {
+    enum : size_t { Handle, Size, Usage, Address, Owner };
+  };
+  struct ImageColumn {
+    enum : size_t { Handle, Format, Extent, Range, Usage, Layout, Owner };
+  };
+  struct ViewColumn {
+    enum : size_t { Handle, Image, Format, Range, Owner };
+  };
+  struct SamplerColumn {
+    enum : size_t { Handle, Owner };
+  };
+
+  // Tables are declared in reverse dependency order, so that views are
+  // destroyed before images.
+  __detail::SoATable<Sampler, VkSampler, __detail::ErasedOwner> m_samplers;
+  __detail::SoATable<ImageInterface, VkImage, VkFormat, VkExtent3D,
+                     VkImageSubresourceRange, VkImageUsageFlags, VkImageLayout,
+                     __detail::ErasedOwner>
+      m_images;
+  __detail::SoATable<ImageViewBase, VkImageView, ImageHandle, VkFormat,
+                     VkImageSubresourceRange, __detail::ErasedOwner>
+      m_views;
+  __detail::SoATable<BufferBase, VkBuffer, VkDeviceSize, VkBufferUsageFlags,
+                     VkDeviceAddress, __detail::ErasedOwner>
+      m_buffers;
+};
+
+} // namespace vkw
+#endif // VKWRAPPER_RESOURCEREGISTRY_HPP
@@ -30,7 +30,8 @@ enum VKW_ErrorCode {
   VKW_OK = 0,
   VKW_VULKAN_LIB_MISSING,
   VKW_SPV_LINK_FAILED,
-  VKW_FATAL
+  VKW_FATAL,
+  VKW_FILE_MAP_FAILED
 };
 
 /* runtime version query */
@@ -168,6 +169,31 @@ VKWRT_EXPORT SpvReflectResult vkw_spvReflectCreateShaderModule(
 VKWRT_EXPORT void
 vkw_spvReflectDestroyShaderModule(SpvReflectShaderModule *p_module);
 
+/* read-only file mapping */
+
+struct VKW_MappedFile_T;
+typedef VKW_MappedFile_T *VKW_MappedFile;
+
+/// @brief Maps whole file into app's address space for reading. Pages are
+/// loaded lazily by os on first access, so mapping itself is cheap.
+///
+/// @param path null-terminated path to file.
+/// @param handle pointer to opaque handle to fill.
+/// @param data out-parameter filling pointer to the first byte of the file.
+/// Null for empty file.
+/// @param size out-parameter filling size of the file in bytes.
+/// @return VKW_OK on success. If file cannot be opened or mapped returns
+/// VKW_FILE_MAP_FAILED and sets handle to null.
+VKWRT_EXPORT VKW_ErrorCode vkw_mapFile(const char *path, VKW_MappedFile *handle,
+                                       const void **data, size_t *size);
+
+/// @brief Unmaps file previously mapped by vkw_mapFile. Pointer to data
+/// becomes invalid.
+///
+/// @param handle must be either null (then this function is no-op) or being
+/// retrieved previously from vkw_mapFile.
+VKWRT_EXPORT void vkw_unmapFile(VKW_MappedFile handle);
+
 /* Embedded default allocators */
 
 VKWRT_EXPORT void *vkw_hostMalloc(size_t size, size_t alignment,
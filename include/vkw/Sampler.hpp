@@ -5,6 +5,22 @@
 
 namespace vkw {
 
+inline bool operator==(VkSamplerCreateInfo const &lhs,
+                       VkSamplerCreateInfo const &rhs) noexcept {
+  return lhs.flags == rhs.flags && lhs.magFilter == rhs.magFilter &&
+         lhs.minFilter == rhs.minFilter && lhs.mipmapMode == rhs.mipmapMode &&
+         lhs.addressModeU == rhs.addressModeU &&
+         lhs.addressModeV == rhs.addressModeV &&
+         lhs.addressModeW == rhs.addressModeW &&
+         lhs.mipLodBias == rhs.mipLodBias &&
+         lhs.anisotropyEnable == rhs.anisotropyEnable &&
+         lhs.maxAnisotropy == rhs.maxAnisotropy &&
+         lhs.compareEnable == rhs.compareEnable &&
+         lhs.compareOp == rhs.compareOp && lhs.minLod == rhs.minLod &&
+         lhs.maxLod == rhs.maxLod && lhs.borderColor == rhs.borderColor &&
+         lhs.unnormalizedCoordinates == rhs.unnormalizedCoordinates;
+}
+
 class Sampler : public vk::Sampler {
 public:
   Sampler(Device const &device,
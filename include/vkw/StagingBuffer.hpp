@@ -3,6 +3,8 @@
 
 #include <vkw/Buffer.hpp>
 
+#include <optional>
+
 namespace vkw {
 /**
  * @class StagingBuffer
@@ -34,5 +36,75 @@ public:
                                         VK_MEMORY_PROPERTY_HOST_CACHED_BIT}) {}
 };
 
+/**
+ * @class StagingRing
+ *
+ * is a persistently mapped staging buffer that is sub-allocated in ring
+ * order. Regions are handed out at the head of the ring. Once the device
+ * work reading them has completed, they are retired by passing a position
+ * previously obtained from head() to release().
+ *
+ */
+class StagingRing {
+public:
+  struct Region {
+    VkDeviceSize offset;
+    std::span<unsigned char> data;
+  };
+
+  StagingRing(DeviceAllocator &allocator,
+              VkDeviceSize capacity) noexcept(ExceptionsDisabled)
+      : m_buffer(allocator, capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                 VmaAllocationCreateInfo{
+                     .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                     .usage = VMA_MEMORY_USAGE_CPU_TO_GPU,
+                     .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT}) {}
+
+  /// Returns region of given size with offset being a multiple of alignment
+  /// or nothing if ring has not enough free space left.
+  std::optional<Region> allocate(VkDeviceSize size,
+                                 VkDeviceSize alignment = 16) noexcept {
+    auto capacity = this->capacity();
+    auto physical = m_head % capacity;
+    auto aligned = (physical + alignment - 1) / alignment * alignment;
+    auto head = m_head + (aligned - physical);
+    if (aligned + size > capacity) {
+      // Region does not fit before the end of the buffer, so the rest of it
+      // is skipped and region is placed at the beginning.
+      head = m_head + (capacity - physical);
+      aligned = 0;
+    }
+
+    if (head + size - m_tail > capacity)
+      return std::nullopt;
+
+    m_head = head + size;
+    return Region{aligned, m_buffer.mapped().subspan(aligned, size)};
+  }
+
+  /// Position to pass to release() once all work recorded so far completes.
+  VkDeviceSize head() const noexcept { return m_head; }
+
+  void release(VkDeviceSize position) noexcept {
+    assert(position <= m_head && "releasing region that was not allocated");
+    m_tail = std::max(m_tail, position);
+  }
+
+  VkDeviceSize capacity() const noexcept { return m_buffer.size(); }
+
+  void flush(Region const &region) noexcept(ExceptionsDisabled) {
+    m_buffer.flush(region.offset, region.data.size());
+  }
+
+  Buffer<unsigned char> const &buffer() const noexcept { return m_buffer; }
+
+private:
+  Buffer<unsigned char> m_buffer;
+  // Both positions grow monotonically, physical offset is position modulo
+  // capacity.
+  VkDeviceSize m_head = 0;
+  VkDeviceSize m_tail = 0;
+};
+
 } // namespace vkw
 #endif // VKWRAPPER_STAGINGBUFFER_HPP
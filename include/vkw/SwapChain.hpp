@@ -2,6 +2,7 @@
 #define VKRENDERER_SWAPCHAIN_HPP
 
 #include <vkw/Containers.hpp>
+#include <vkw/Expected.hpp>
 #include <vkw/Extensions.hpp>
 #include <vkw/Fence.hpp>
 #include <vkw/Image.hpp>
@@ -65,6 +66,26 @@ public:
     return acquireNextImageImpl(VK_NULL_HANDLE, signalFence, timeout);
   }
 
+  /** Same as acquireNextImage(), but errors other than statuses above (e.g.
+   * VK_ERROR_SURFACE_LOST_KHR) are returned instead of posted. **/
+
+  Expected<AcquireStatus>
+  try_acquireNextImage(Semaphore const &signalSemaphore,
+                       Fence const &signalFence,
+                       uint64_t timeout = UINT64_MAX) noexcept {
+    return m_tryAcquire(signalSemaphore, signalFence, timeout);
+  }
+  Expected<AcquireStatus>
+  try_acquireNextImage(Semaphore const &signalSemaphore,
+                       uint64_t timeout = UINT64_MAX) noexcept {
+    return m_tryAcquire(signalSemaphore, VK_NULL_HANDLE, timeout);
+  }
+  Expected<AcquireStatus>
+  try_acquireNextImage(Fence const &signalFence,
+                       uint64_t timeout = UINT64_MAX) noexcept {
+    return m_tryAcquire(VK_NULL_HANDLE, signalFence, timeout);
+  }
+
   auto images() const noexcept {
     return std::ranges::subrange(m_images.begin(), m_images.end());
   }
@@ -85,6 +106,14 @@ private:
   AcquireStatus
   acquireNextImageImpl(VkSemaphore semaphore, VkFence fence,
                        uint64_t timeout) noexcept(ExceptionsDisabled) {
+    auto status = m_tryAcquire(semaphore, fence, timeout);
+    if (!status)
+      VK_CHECK_RESULT(status.error())
+    return status.value_or(AcquireStatus::OUT_OF_DATE);
+  }
+
+  Expected<AcquireStatus> m_tryAcquire(VkSemaphore semaphore, VkFence fence,
+                                       uint64_t timeout) noexcept {
     uint32_t imageIndex;
     auto result = extension().vkAcquireNextImageKHR(
         m_swapchain.get_deleter().device.get(), m_swapchain.get(), timeout,
@@ -104,8 +133,7 @@ private:
     case VK_ERROR_OUT_OF_DATE_KHR:
       return AcquireStatus::OUT_OF_DATE;
     default:
-      VK_CHECK_RESULT(result)
-      return AcquireStatus::OUT_OF_DATE;
+      return Unexpected{result};
     }
   }
 
@@ -29,5 +29,63 @@ public:
 private:
 };
 
+/**
+ * @class DynamicUniformArray
+ *
+ * is a uniform buffer holding count elements of T, each starting at a
+ * multiple of minUniformBufferOffsetAlignment. It is meant to be bound once
+ * to a dynamic uniform buffer descriptor with range elementRange(), then
+ * element is selected per draw with DescriptorSet::setDynamicOffset.
+ *
+ * Indexed access requires buffer to be mapped.
+ */
+template <typename T> class DynamicUniformArray : public Buffer<unsigned char> {
+public:
+  DynamicUniformArray(
+      DeviceAllocator &allocator, uint64_t count,
+      AllocationCreateInfo const &createInfo, VkBufferUsageFlags usage = 0,
+      SharingInfo const &sharingInfo = {}) noexcept(ExceptionsDisabled)
+      : Buffer<unsigned char>(allocator, m_alignedStride(allocator) * count,
+                              usage | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                              createInfo, sharingInfo),
+        m_stride(m_alignedStride(allocator)), m_count(count) {}
+
+  T &operator[](uint64_t index) const noexcept {
+    auto bytes = mapped();
+    assert(!bytes.empty() && "buffer is not mapped");
+    assert(index < m_count && "index out of range");
+    return *reinterpret_cast<T *>(bytes.data() + index * m_stride);
+  }
+
+  /// Offset to pass to DescriptorSet::setDynamicOffset to select element.
+  uint32_t dynamicOffset(uint64_t index) const noexcept {
+    return static_cast<uint32_t>(index * m_stride);
+  }
+
+  /// Descriptor range that covers single element.
+  static constexpr VkDeviceSize elementRange() noexcept { return sizeof(T); }
+
+  VkDeviceSize stride() const noexcept { return m_stride; }
+
+  uint64_t count() const noexcept { return m_count; }
+
+  /// Flushes element written through non-coherent mapping.
+  void flushElement(uint64_t index) noexcept(ExceptionsDisabled) {
+    flush(index * m_stride, sizeof(T));
+  }
+
+private:
+  static VkDeviceSize m_alignedStride(DeviceAllocator &allocator) noexcept {
+    VkDeviceSize alignment = allocator.parent()
+                                 .physicalDevice()
+                                 .properties()
+                                 .limits.minUniformBufferOffsetAlignment;
+    return (sizeof(T) + alignment - 1) / alignment * alignment;
+  }
+
+  VkDeviceSize m_stride;
+  uint64_t m_count;
+};
+
 } // namespace vkw
 #endif // VKWRAPPER_UNIFORMBUFFER_HPP
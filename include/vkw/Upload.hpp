@@ -0,0 +1,108 @@
+#ifndef VKWRAPPER_UPLOAD_HPP
+#define VKWRAPPER_UPLOAD_HPP
+
+#include <vkw/CommandRecorder.hpp>
+#include <vkw/StagingBuffer.hpp>
+
+#include <cstring>
+#include <optional>
+
+namespace vkw {
+
+/** The way data reached device buffer. */
+enum class UploadPath {
+  /// Written by the host straight into device buffer memory.
+  Direct,
+  /// Written into staging buffer and copied on the device.
+  Staging
+};
+
+struct UploadResult {
+  UploadPath path;
+  /// Staging buffer for UploadPath::Staging. It must be kept alive until
+  /// recorded copy completes.
+  std::optional<StagingBuffer<unsigned char>> staging;
+};
+
+/**
+ * Returns true if device has memory that is both device local and host
+ * visible in a heap large enough for bulk data, i.e. resizable BAR, UMA or
+ * software devices. 256 MiB BAR window of discrete GPUs without resizable
+ * BAR is not counted, it is too small to hold resources.
+ */
+inline bool directUploadAvailable(PhysicalDevice const &device) noexcept {
+  constexpr VkDeviceSize smallBarSize = 256ull << 20;
+  constexpr VkMemoryPropertyFlags flags =
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+  auto const &memory = device.memoryProperties();
+  for (uint32_t i = 0; i < memory.memoryTypeCount; ++i) {
+    auto const &type = memory.memoryTypes[i];
+    if ((type.propertyFlags & flags) == flags &&
+        memory.memoryHeaps[type.heapIndex].size > smallBarSize)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Allocation info for device buffers that are filled by the host. Memory
+ * that is device local and host visible is picked when available and
+ * buffer stays mapped. Otherwise buffer lands in device local memory and
+ * has to be filled through staging, so it needs TRANSFER_DST usage.
+ */
+inline AllocationCreateInfo directUploadAllocationInfo() noexcept {
+  return AllocationCreateInfo{
+      .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+               VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+               VMA_ALLOCATION_CREATE_MAPPED_BIT,
+      .usage = VMA_MEMORY_USAGE_AUTO};
+}
+
+/**
+ * Writes data to dst at offset. Mapped host visible buffers are written
+ * directly, host writes become visible to the device on next queue submit.
+ * Otherwise data is staged and copy is recorded followed by a barrier to
+ * dstStage/dstAccess.
+ */
+inline UploadResult
+upload(TransferPassRecorder &recorder, DeviceAllocator &allocator,
+       BufferBase &dst, VkDeviceSize offset,
+       std::span<const unsigned char> data,
+       VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+       VkAccessFlags dstAccess =
+           VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+           VK_ACCESS_INDEX_READ_BIT) noexcept(ExceptionsDisabled) {
+  assert(offset + data.size() <= dst.bufferSize() && "upload out of range");
+
+  auto mapped = dst.mapped<unsigned char>();
+  if (!mapped.empty() && dst.mappable()) {
+    std::memcpy(mapped.data() + offset, data.data(), data.size());
+    if (!dst.coherent())
+      dst.flush(offset, data.size());
+    return UploadResult{UploadPath::Direct, std::nullopt};
+  }
+
+  assert(dst.canBeCopyDst() && "buffer is not a transfer destination");
+  UploadResult ret{UploadPath::Staging, std::nullopt};
+  ret.staging.emplace(allocator, data);
+  ret.staging->flush();
+
+  VkBufferCopy region{0, offset, data.size()};
+  recorder.copyBufferToBuffer(*ret.staging, dst, {&region, 1});
+
+  VkBufferMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = dstAccess;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.buffer = dst;
+  barrier.offset = offset;
+  barrier.size = data.size();
+  recorder.bufferMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage,
+                               {&barrier, 1});
+  return ret;
+}
+
+} // namespace vkw
+#endif // VKWRAPPER_UPLOAD_HPP
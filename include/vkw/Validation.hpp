@@ -5,9 +5,19 @@
 #include <vkw/Instance.hpp>
 #include <vkw/Layers.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <chrono>
 #include <concepts>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace vkw::debug {
 
@@ -137,6 +147,111 @@ struct Message {
   std::string_view what;
 };
 
+/**
+ * Settings of asynchronous message delivery. Messages are copied into a
+ * bounded queue and the callback runs on a background thread. Each message
+ * id is delivered at most maxPerWindow times per window, the rest is only
+ * counted.
+ */
+struct AsyncDelivery {
+  size_t queueCapacity = 256;
+  unsigned maxPerWindow = 5;
+  std::chrono::milliseconds window{1000};
+  // Longer texts are truncated, so that queueing never allocates.
+  size_t maxMessageLength = 4096;
+};
+
+struct MessageCounter {
+  int id;
+  std::string name;
+  uint64_t total;
+  uint64_t suppressed;
+};
+
+struct MessageStatistics {
+  std::vector<MessageCounter> messages;
+  // Messages lost because the queue was full.
+  uint64_t dropped;
+};
+
+namespace __detail {
+
+/**
+ * Bounded lock-free multi-producer queue after D. Vyukov, with a single
+ * consumer. Slot strings are allocated upfront and never grow.
+ */
+class MessageQueue {
+public:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    MsgSeverity severity;
+    MsgType type;
+    int id;
+    std::string name;
+    std::string what;
+  };
+
+  MessageQueue(size_t capacity, size_t maxMessageLength)
+      : m_capacity(std::bit_ceil(std::max<size_t>(capacity, 2))),
+        m_slots(std::make_unique<Slot[]>(m_capacity)) {
+    for (size_t i = 0; i < m_capacity; ++i) {
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+      m_slots[i].name.reserve(128);
+      m_slots[i].what.reserve(maxMessageLength);
+    }
+  }
+
+  /// Returns false if queue is full.
+  bool push(MsgSeverity severity, MsgType type, int id, std::string_view name,
+            std::string_view what) noexcept {
+    auto position = m_enqueue.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;) {
+      slot = &m_slots[position & (m_capacity - 1)];
+      auto sequence = slot->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(sequence - position);
+      if (diff == 0) {
+        if (m_enqueue.compare_exchange_weak(position, position + 1,
+                                            std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->severity = severity;
+    slot->type = type;
+    slot->id = id;
+    slot->name.assign(name.data(),
+                      std::min(name.size(), slot->name.capacity()));
+    slot->what.assign(what.data(),
+                      std::min(what.size(), slot->what.capacity()));
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side. Calls fn with the oldest slot, returns false if empty.
+  template <std::invocable<Slot const &> Fn> bool pop(Fn &&fn) {
+    auto &slot = m_slots[m_dequeue & (m_capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != m_dequeue + 1)
+      return false;
+    fn(slot);
+    slot.sequence.store(m_dequeue + m_capacity, std::memory_order_release);
+    ++m_dequeue;
+    return true;
+  }
+
+private:
+  size_t m_capacity;
+  std::unique_ptr<Slot[]> m_slots;
+  alignas(64) std::atomic<size_t> m_enqueue = 0;
+  alignas(64) size_t m_dequeue = 0;
+};
+
+} // namespace __detail
+
 class Validation {
 public:
   template <std::invocable<MsgSeverity, MsgType, Message const &> Fn>
@@ -146,21 +261,32 @@ public:
                       MsgTypeFlags typeFilter =
                           MsgType::General |
                           MsgType::Validation) noexcept(ExceptionsDisabled)
-      : m_handler(std::make_unique<MessageHandler>(std::forward<Fn>(callback))),
-        m_messenger(nullptr, MessengerDestructor{instance}) {
-    VkDebugUtilsMessengerCreateInfoEXT debugUtilsMessengerCI{};
-    debugUtilsMessengerCI.sType =
-        VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-    debugUtilsMessengerCI.messageSeverity =
-        __detail::severityConvert(severityFilter);
-    debugUtilsMessengerCI.messageType = __detail::typeConvert(typeFilter);
-    debugUtilsMessengerCI.pUserData = m_handler.get();
-    debugUtilsMessengerCI.pfnUserCallback = &MessageHandler::CallbackEntry;
-    VkDebugUtilsMessengerEXT tmpMsg = nullptr;
-
-    VK_CHECK_RESULT(m_ext().vkCreateDebugUtilsMessengerEXT(
-        instance, &debugUtilsMessengerCI, HostAllocator::get(), &tmpMsg));
-    m_messenger.reset(tmpMsg);
+      : Validation(instance,
+                   std::make_unique<MessageHandler>(std::forward<Fn>(callback)),
+                   severityFilter, typeFilter) {}
+
+  /**
+   * Delivers messages asynchronously, see AsyncDelivery. Callback is called
+   * from a background thread, one message at a time. Messages still queued
+   * on destruction are delivered before it returns.
+   */
+  template <std::invocable<MsgSeverity, MsgType, Message const &> Fn>
+  Validation(Instance const &instance, Fn &&callback,
+             AsyncDelivery const &delivery,
+             MsgSeverityFlags severityFilter = MsgSeverity::Warning |
+                                               MsgSeverity::Error,
+             MsgTypeFlags typeFilter = MsgType::General | MsgType::Validation)
+      : Validation(instance,
+                   std::make_unique<MessageHandler>(
+                       CallbackFn{}, std::make_unique<AsyncDispatcher>(
+                                         std::forward<Fn>(callback), delivery)),
+                   severityFilter, typeFilter) {}
+
+  /// Per message id counters of asynchronous delivery.
+  MessageStatistics statistics() const {
+    if (!m_handler->async)
+      return {};
+    return m_handler->async->statistics();
   }
 
   virtual ~Validation() = default;
@@ -168,8 +294,109 @@ public:
 private:
   using CallbackFn = std::function<void(MsgSeverity severity, MsgType type,
                                         Message const &message)>;
+
+  class AsyncDispatcher {
+  public:
+    AsyncDispatcher(CallbackFn callback, AsyncDelivery const &delivery)
+        : m_callback(std::move(callback)), m_delivery(delivery),
+          m_queue(delivery.queueCapacity, delivery.maxMessageLength),
+          m_worker([this]() { m_work(); }) {}
+
+    void push(MsgSeverity severity, MsgType type,
+              const VkDebugUtilsMessengerCallbackDataEXT &data) noexcept {
+      std::string_view name = data.pMessageIdName ? data.pMessageIdName : "";
+      std::string_view what = data.pMessage ? data.pMessage : "";
+      if (!m_queue.push(severity, type, data.messageIdNumber, name, what)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      m_signal.fetch_add(1, std::memory_order_release);
+      m_signal.notify_one();
+    }
+
+    MessageStatistics statistics() const {
+      MessageStatistics ret{};
+      std::lock_guard<std::mutex> lock{m_mutex};
+      for (auto const &[id, counter] : m_counters)
+        ret.messages.push_back(MessageCounter{id, counter.name, counter.total,
+                                              counter.suppressed});
+      ret.dropped = m_dropped.load(std::memory_order_relaxed);
+      return ret;
+    }
+
+    ~AsyncDispatcher() {
+      m_stop.store(true, std::memory_order_release);
+      m_signal.fetch_add(1, std::memory_order_release);
+      m_signal.notify_one();
+      m_worker.join();
+    }
+
+  private:
+    struct Counter {
+      std::string name;
+      uint64_t total = 0;
+      uint64_t suppressed = 0;
+      std::chrono::steady_clock::time_point windowStart{};
+      unsigned windowCount = 0;
+    };
+
+    void m_work() {
+      auto deliver = [this](__detail::MessageQueue::Slot const &slot) {
+        m_deliver(slot);
+      };
+      for (;;) {
+        // Signal is read before draining, so that a push made after the
+        // drain changes it and wait() returns.
+        auto signal = m_signal.load(std::memory_order_acquire);
+        while (m_queue.pop(deliver))
+          ;
+        if (m_stop.load(std::memory_order_acquire)) {
+          while (m_queue.pop(deliver))
+            ;
+          return;
+        }
+        m_signal.wait(signal, std::memory_order_acquire);
+      }
+    }
+
+    void m_deliver(__detail::MessageQueue::Slot const &slot) {
+      auto now = std::chrono::steady_clock::now();
+      bool deliver = false;
+      {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        auto &counter = m_counters[slot.id];
+        if (counter.total++ == 0)
+          counter.name = slot.name;
+        if (now - counter.windowStart >= m_delivery.window) {
+          counter.windowStart = now;
+          counter.windowCount = 0;
+        }
+        deliver = counter.windowCount < m_delivery.maxPerWindow;
+        if (deliver)
+          ++counter.windowCount;
+        else
+          ++counter.suppressed;
+      }
+      if (deliver)
+        std::invoke(m_callback, slot.severity, slot.type,
+                    Message{slot.id, slot.name, slot.what});
+    }
+
+    CallbackFn m_callback;
+    AsyncDelivery m_delivery;
+    __detail::MessageQueue m_queue;
+    mutable std::mutex m_mutex;
+    std::unordered_map<int, Counter> m_counters;
+    std::atomic<uint64_t> m_dropped = 0;
+    std::atomic<uint32_t> m_signal = 0;
+    std::atomic<bool> m_stop = false;
+    // Declared last so that it starts after everything it touches.
+    std::thread m_worker;
+  };
+
   struct MessageHandler {
     CallbackFn callback;
+    std::unique_ptr<AsyncDispatcher> async;
     static VKAPI_ATTR VkBool32 VKAPI_CALL
     CallbackEntry(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
                   VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -185,6 +412,10 @@ private:
                  const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData) {
       auto severity = __detail::toSeverity(messageSeverity);
       auto msgType = __detail::toType(messageType);
+      if (async) {
+        async->push(severity, msgType, *pCallbackData);
+        return severity == MsgSeverity::Error;
+      }
       Message message{pCallbackData->messageIdNumber,
                       pCallbackData->pMessageIdName, pCallbackData->pMessage};
       std::invoke(callback, severity, msgType, message);
@@ -192,6 +423,26 @@ private:
     }
   };
 
+  Validation(Instance const &instance, std::unique_ptr<MessageHandler> handler,
+             MsgSeverityFlags severityFilter,
+             MsgTypeFlags typeFilter) noexcept(ExceptionsDisabled)
+      : m_handler(std::move(handler)),
+        m_messenger(nullptr, MessengerDestructor{instance}) {
+    VkDebugUtilsMessengerCreateInfoEXT debugUtilsMessengerCI{};
+    debugUtilsMessengerCI.sType =
+        VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+    debugUtilsMessengerCI.messageSeverity =
+        __detail::severityConvert(severityFilter);
+    debugUtilsMessengerCI.messageType = __detail::typeConvert(typeFilter);
+    debugUtilsMessengerCI.pUserData = m_handler.get();
+    debugUtilsMessengerCI.pfnUserCallback = &MessageHandler::CallbackEntry;
+    VkDebugUtilsMessengerEXT tmpMsg = nullptr;
+
+    VK_CHECK_RESULT(m_ext().vkCreateDebugUtilsMessengerEXT(
+        instance, &debugUtilsMessengerCI, HostAllocator::get(), &tmpMsg));
+    m_messenger.reset(tmpMsg);
+  }
+
   const Instance &m_instance() const noexcept {
     return m_messenger.get_deleter().instance;
   }
@@ -22,7 +22,18 @@ enum class VertexAttributeType {
   VEC2U8,
   UINT,
   UINT16,
-  UINT8
+  UINT8,
+  VEC4H,
+  VEC2H,
+  SNORM16x4,
+  SNORM16x2,
+  UNORM16x4,
+  UNORM16x2,
+  SNORM8x4,
+  // Vertex fetch support of this format is optional, check
+  // VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT before use.
+  A2B10G10R10_SNORM,
+  A2B10G10R10_UNORM
 };
 
 constexpr uint64_t size_of(VertexAttributeType attrType) {
@@ -62,6 +73,19 @@ constexpr uint64_t size_of(VertexAttributeType attrType) {
     return sizeof(uint16_t);
   case VertexAttributeType::UINT8:
     return sizeof(uint8_t);
+  case VertexAttributeType::VEC4H:
+  case VertexAttributeType::SNORM16x4:
+  case VertexAttributeType::UNORM16x4:
+    return 4 * sizeof(uint16_t);
+  case VertexAttributeType::VEC2H:
+  case VertexAttributeType::SNORM16x2:
+  case VertexAttributeType::UNORM16x2:
+    return 2 * sizeof(uint16_t);
+  case VertexAttributeType::SNORM8x4:
+    return 4 * sizeof(uint8_t);
+  case VertexAttributeType::A2B10G10R10_SNORM:
+  case VertexAttributeType::A2B10G10R10_UNORM:
+    return sizeof(uint32_t);
   }
   return 0;
 }
@@ -102,6 +126,24 @@ constexpr VkFormat format_of(VertexAttributeType attrType) {
     return VK_FORMAT_R16_UINT;
   case VertexAttributeType::UINT8:
     return VK_FORMAT_R8_UINT;
+  case VertexAttributeType::VEC4H:
+    return VK_FORMAT_R16G16B16A16_SFLOAT;
+  case VertexAttributeType::VEC2H:
+    return VK_FORMAT_R16G16_SFLOAT;
+  case VertexAttributeType::SNORM16x4:
+    return VK_FORMAT_R16G16B16A16_SNORM;
+  case VertexAttributeType::SNORM16x2:
+    return VK_FORMAT_R16G16_SNORM;
+  case VertexAttributeType::UNORM16x4:
+    return VK_FORMAT_R16G16B16A16_UNORM;
+  case VertexAttributeType::UNORM16x2:
+    return VK_FORMAT_R16G16_UNORM;
+  case VertexAttributeType::SNORM8x4:
+    return VK_FORMAT_R8G8B8A8_SNORM;
+  case VertexAttributeType::A2B10G10R10_SNORM:
+    return VK_FORMAT_A2B10G10R10_SNORM_PACK32;
+  case VertexAttributeType::A2B10G10R10_UNORM:
+    return VK_FORMAT_A2B10G10R10_UNORM_PACK32;
   }
 
   return VK_FORMAT_MAX_ENUM;
@@ -126,11 +168,56 @@ constexpr uint32_t locations_hold(VertexAttributeType attrType) {
   case VertexAttributeType::UINT:
   case VertexAttributeType::UINT16:
   case VertexAttributeType::UINT8:
+  case VertexAttributeType::VEC4H:
+  case VertexAttributeType::VEC2H:
+  case VertexAttributeType::SNORM16x4:
+  case VertexAttributeType::SNORM16x2:
+  case VertexAttributeType::UNORM16x4:
+  case VertexAttributeType::UNORM16x2:
+  case VertexAttributeType::SNORM8x4:
+  case VertexAttributeType::A2B10G10R10_SNORM:
+  case VertexAttributeType::A2B10G10R10_UNORM:
     return 1u;
   }
   return 0xFFFFFFFF;
 }
 
+constexpr uint32_t components_of(VertexAttributeType attrType) {
+  switch (attrType) {
+  case VertexAttributeType::VEC4F:
+  case VertexAttributeType::RGBA8_UNORM:
+  case VertexAttributeType::VEC4U:
+  case VertexAttributeType::VEC4U16:
+  case VertexAttributeType::VEC4U8:
+  case VertexAttributeType::VEC4H:
+  case VertexAttributeType::SNORM16x4:
+  case VertexAttributeType::UNORM16x4:
+  case VertexAttributeType::SNORM8x4:
+  case VertexAttributeType::A2B10G10R10_SNORM:
+  case VertexAttributeType::A2B10G10R10_UNORM:
+    return 4u;
+  case VertexAttributeType::VEC3F:
+  case VertexAttributeType::VEC3U:
+  case VertexAttributeType::VEC3U16:
+  case VertexAttributeType::VEC3U8:
+    return 3u;
+  case VertexAttributeType::VEC2F:
+  case VertexAttributeType::VEC2U:
+  case VertexAttributeType::VEC2U16:
+  case VertexAttributeType::VEC2U8:
+  case VertexAttributeType::VEC2H:
+  case VertexAttributeType::SNORM16x2:
+  case VertexAttributeType::UNORM16x2:
+    return 2u;
+  case VertexAttributeType::FLOAT:
+  case VertexAttributeType::UINT:
+  case VertexAttributeType::UINT16:
+  case VertexAttributeType::UINT8:
+    return 1u;
+  }
+  return 0;
+}
+
 /** @Concept: Any struct used as attribute holder for Vertex Buffer should be
  * AttributeArrayLike */
 template <typename T>
@@ -170,6 +257,15 @@ public:
   constexpr static const bool value = validate();
 };
 
+/** Byte offset of attribute elem inside of T. */
+template <AttributeArrayLike T>
+constexpr uint64_t attribute_offset(uint32_t elem) {
+  uint64_t offset = 0;
+  for (uint32_t i = 0; i < elem; ++i)
+    offset += size_of(T::getAttrType(i));
+  return offset;
+}
+
 /** @Concept: Any struct used by Vertex Buffer should satisfy AttributeArray
  * restrictions */
 template <typename T>
@@ -238,5 +334,22 @@ public:
             allocator, count, usage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
             createInfo, sharingInfo) {}
 };
+
+/** @template: draw parameters buffer, T is one of Vk*IndirectCommand */
+template <typename T>
+concept IndirectCommand = std::same_as<T, VkDrawIndirectCommand> ||
+                          std::same_as<T, VkDrawIndexedIndirectCommand> ||
+                          std::same_as<T, VkDispatchIndirectCommand>;
+
+template <IndirectCommand T> class IndirectBuffer : public Buffer<T> {
+public:
+  IndirectBuffer(DeviceAllocator &allocator, uint64_t count,
+                 AllocationCreateInfo const &createInfo,
+                 VkBufferUsageFlags usage = 0,
+                 SharingInfo const &sharingInfo = {}) noexcept(
+      ExceptionsDisabled)
+      : Buffer<T>(allocator, count, usage | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                  createInfo, sharingInfo) {}
+};
 } // namespace vkw
 #endif // VKRENDERER_VERTEXBUFFER_HPP
@@ -0,0 +1,280 @@
+#ifndef VKWRAPPER_VERTEXPACKING_HPP
+#define VKWRAPPER_VERTEXPACKING_HPP
+
+#include <vkw/PixelConversion.hpp>
+#include <vkw/VertexBuffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace vkw {
+
+/**
+ * Vertex attribute quantization kernels.
+ *
+ * Kernels convert float data into half, normalized and packed attribute
+ * types. Values are clamped to representable range and rounded to nearest
+ * even, NaN is converted to the lower bound. Like pixel conversion kernels
+ * they use SSE4.1 or NEON when enabled at compile time and produce identical
+ * results on every path.
+ */
+
+namespace __detail {
+
+// Clamp that maps NaN to lo, same as (v)maxnm/max_ps with lo as second
+// operand.
+inline float m_clampNorm(float value, float lo, float hi) noexcept {
+  value = value > lo ? value : lo;
+  return value < hi ? value : hi;
+}
+
+inline int32_t m_quantize(float value, float lo, float hi,
+                          float scale) noexcept {
+  return static_cast<int32_t>(
+      std::nearbyint(m_clampNorm(value, lo, hi) * scale));
+}
+
+#if defined(__SSE4_1__)
+inline __m128i m_quantize4(float const *src, __m128 lo, __m128 hi,
+                           __m128 scale) noexcept {
+  auto v = _mm_max_ps(_mm_loadu_ps(src), lo);
+  v = _mm_min_ps(v, hi);
+  return _mm_cvtps_epi32(_mm_mul_ps(v, scale));
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+inline int32x4_t m_quantize4(float const *src, float32x4_t lo,
+                             float32x4_t hi, float32x4_t scale) noexcept {
+  auto v = vmaxnmq_f32(vld1q_f32(src), lo);
+  v = vminq_f32(v, hi);
+  return vcvtnq_s32_f32(vmulq_f32(v, scale));
+}
+#endif
+
+} // namespace __detail
+
+/** Converts floats in [-1, 1] to 16 bit signed normalized values. */
+inline void convertF32ToSnorm16(std::span<const float> src,
+                                std::span<int16_t> dst) noexcept {
+  assert(dst.size() >= src.size() && "destination is too small");
+  size_t i = 0;
+  auto count = src.size();
+
+#if defined(__SSE4_1__)
+  auto lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f);
+  auto scale = _mm_set1_ps(32767.0f);
+  for (; i + 8 <= count; i += 8) {
+    auto a = __detail::m_quantize4(src.data() + i, lo, hi, scale);
+    auto b = __detail::m_quantize4(src.data() + i + 4, lo, hi, scale);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst.data() + i),
+                     _mm_packs_epi32(a, b));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  auto lo = vdupq_n_f32(-1.0f), hi = vdupq_n_f32(1.0f);
+  auto scale = vdupq_n_f32(32767.0f);
+  for (; i + 4 <= count; i += 4) {
+    auto v = __detail::m_quantize4(src.data() + i, lo, hi, scale);
+    vst1_s16(dst.data() + i, vqmovn_s32(v));
+  }
+#endif
+
+  for (; i < count; ++i)
+    dst[i] = __detail::m_quantize(src[i], -1.0f, 1.0f, 32767.0f);
+}
+
+/** Converts floats in [0, 1] to 16 bit unsigned normalized values. */
+inline void convertF32ToUnorm16(std::span<const float> src,
+                                std::span<uint16_t> dst) noexcept {
+  assert(dst.size() >= src.size() && "destination is too small");
+  size_t i = 0;
+  auto count = src.size();
+
+#if defined(__SSE4_1__)
+  auto lo = _mm_setzero_ps(), hi = _mm_set1_ps(1.0f);
+  auto scale = _mm_set1_ps(65535.0f);
+  for (; i + 8 <= count; i += 8) {
+    auto a = __detail::m_quantize4(src.data() + i, lo, hi, scale);
+    auto b = __detail::m_quantize4(src.data() + i + 4, lo, hi, scale);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst.data() + i),
+                     _mm_packus_epi32(a, b));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  auto lo = vdupq_n_f32(0.0f), hi = vdupq_n_f32(1.0f);
+  auto scale = vdupq_n_f32(65535.0f);
+  for (; i + 4 <= count; i += 4) {
+    auto v = __detail::m_quantize4(src.data() + i, lo, hi, scale);
+    vst1_u16(dst.data() + i, vqmovun_s32(v));
+  }
+#endif
+
+  for (; i < count; ++i)
+    dst[i] = __detail::m_quantize(src[i], 0.0f, 1.0f, 65535.0f);
+}
+
+/** Converts floats in [-1, 1] to 8 bit signed normalized values. */
+inline void convertF32ToSnorm8(std::span<const float> src,
+                               std::span<int8_t> dst) noexcept {
+  assert(dst.size() >= src.size() && "destination is too small");
+  size_t i = 0;
+  auto count = src.size();
+
+#if defined(__SSE4_1__)
+  auto lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f);
+  auto scale = _mm_set1_ps(127.0f);
+  for (; i + 16 <= count; i += 16) {
+    auto *in = src.data() + i;
+    auto a = _mm_packs_epi32(__detail::m_quantize4(in, lo, hi, scale),
+                             __detail::m_quantize4(in + 4, lo, hi, scale));
+    auto b = _mm_packs_epi32(__detail::m_quantize4(in + 8, lo, hi, scale),
+                             __detail::m_quantize4(in + 12, lo, hi, scale));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst.data() + i),
+                     _mm_packs_epi16(a, b));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  auto lo = vdupq_n_f32(-1.0f), hi = vdupq_n_f32(1.0f);
+  auto scale = vdupq_n_f32(127.0f);
+  for (; i + 8 <= count; i += 8) {
+    auto a = vqmovn_s32(__detail::m_quantize4(src.data() + i, lo, hi, scale));
+    auto b =
+        vqmovn_s32(__detail::m_quantize4(src.data() + i + 4, lo, hi, scale));
+    vst1_s8(dst.data() + i, vqmovn_s16(vcombine_s16(a, b)));
+  }
+#endif
+
+  for (; i < count; ++i)
+    dst[i] = __detail::m_quantize(src[i], -1.0f, 1.0f, 127.0f);
+}
+
+/**
+ * Packs groups of 4 floats (x, y, z, w) into A2B10G10R10_SNORM_PACK32 or
+ * A2B10G10R10_UNORM_PACK32 values. x goes to the lowest bits.
+ */
+inline void convertF32ToA2B10G10R10(std::span<const float> src,
+                                    std::span<uint32_t> dst,
+                                    bool normalizedSigned) noexcept {
+  assert(src.size() % 4 == 0 && "source is not made of 4 components");
+  assert(dst.size() >= src.size() / 4 && "destination is too small");
+  float lo = normalizedSigned ? -1.0f : 0.0f;
+  float rgbScale = normalizedSigned ? 511.0f : 1023.0f;
+  float alphaScale = normalizedSigned ? 1.0f : 3.0f;
+  auto count = src.size() / 4;
+
+  // Plain loop, compilers vectorize it well enough.
+  for (size_t i = 0; i < count; ++i) {
+    auto const *in = src.data() + 4 * i;
+    auto r = __detail::m_quantize(in[0], lo, 1.0f, rgbScale);
+    auto g = __detail::m_quantize(in[1], lo, 1.0f, rgbScale);
+    auto b = __detail::m_quantize(in[2], lo, 1.0f, rgbScale);
+    auto a = __detail::m_quantize(in[3], lo, 1.0f, alphaScale);
+    dst[i] = (uint32_t(r) & 0x3FFu) | (uint32_t(g) & 0x3FFu) << 10u |
+             (uint32_t(b) & 0x3FFu) << 20u | (uint32_t(a) & 0x3u) << 30u;
+  }
+}
+
+/**
+ * Converts components_of(type) floats per attribute from src into tightly
+ * packed attributes of type in dst. Integer types are not supported.
+ */
+inline void packVertexAttributes(VertexAttributeType type,
+                                 std::span<const float> src,
+                                 std::span<unsigned char> dst) noexcept {
+  auto count = src.size() / components_of(type);
+  assert(dst.size() >= count * size_of(type) && "destination is too small");
+  auto *out = dst.data();
+
+  switch (type) {
+  case VertexAttributeType::VEC4F:
+  case VertexAttributeType::VEC3F:
+  case VertexAttributeType::VEC2F:
+  case VertexAttributeType::FLOAT:
+    std::memcpy(out, src.data(), src.size_bytes());
+    break;
+  case VertexAttributeType::VEC4H:
+  case VertexAttributeType::VEC2H:
+    convertF32ToF16(src, {reinterpret_cast<uint16_t *>(out), src.size()});
+    break;
+  case VertexAttributeType::SNORM16x4:
+  case VertexAttributeType::SNORM16x2:
+    convertF32ToSnorm16(src, {reinterpret_cast<int16_t *>(out), src.size()});
+    break;
+  case VertexAttributeType::UNORM16x4:
+  case VertexAttributeType::UNORM16x2:
+    convertF32ToUnorm16(src, {reinterpret_cast<uint16_t *>(out), src.size()});
+    break;
+  case VertexAttributeType::SNORM8x4:
+    convertF32ToSnorm8(src, {reinterpret_cast<int8_t *>(out), src.size()});
+    break;
+  case VertexAttributeType::RGBA8_UNORM:
+    for (size_t i = 0; i < src.size(); ++i)
+      out[i] = __detail::m_quantize(src[i], 0.0f, 1.0f, 255.0f);
+    break;
+  case VertexAttributeType::A2B10G10R10_SNORM:
+  case VertexAttributeType::A2B10G10R10_UNORM:
+    convertF32ToA2B10G10R10(
+        src, {reinterpret_cast<uint32_t *>(out), count},
+        type == VertexAttributeType::A2B10G10R10_SNORM);
+    break;
+  default:
+    assert(false && "attribute type can not be packed from floats");
+  }
+}
+
+/**
+ * Writes attribute of every vertex from float data. src holds
+ * components_of(T::getAttrType(attribute)) floats per vertex. Vertices may
+ * point to mapped vertex buffer memory.
+ */
+template <AttributeArray T>
+void packAttribute(std::span<T> vertices, uint32_t attribute,
+                   std::span<const float> src) noexcept {
+  auto type = T::getAttrType(attribute);
+  auto components = components_of(type);
+  auto size = size_of(type);
+  assert(src.size() >= vertices.size() * components &&
+         "not enough source data");
+
+  auto *out = reinterpret_cast<unsigned char *>(vertices.data());
+  if (size == sizeof(T)) {
+    packVertexAttributes(type, src.first(vertices.size() * components),
+                         {out, vertices.size() * size});
+    return;
+  }
+
+  // Attributes are interleaved: pack chunk into a local array first, so
+  // that kernels work on contiguous data, then scatter it.
+  constexpr size_t chunkSize = 256;
+  alignas(16) unsigned char packed[chunkSize * 4 * sizeof(float)];
+  auto offset = attribute_offset<T>(attribute);
+  for (size_t first = 0; first < vertices.size(); first += chunkSize) {
+    auto count = std::min(chunkSize, vertices.size() - first);
+    packVertexAttributes(type,
+                         src.subspan(first * components, count * components),
+                         {packed, count * size});
+    for (size_t i = 0; i < count; ++i)
+      std::memcpy(out + (first + i) * sizeof(T) + offset, packed + i * size,
+                  size);
+  }
+}
+
+/**
+ * Writes attribute of vertices starting from firstVertex of mappable buffer
+ * and flushes written range.
+ */
+template <AttributeArray T>
+void packAttribute(VertexBuffer<T> &buffer, uint32_t attribute,
+                   std::span<const float> src,
+                   uint64_t firstVertex = 0) noexcept(ExceptionsDisabled) {
+  auto vertices = buffer.mapped();
+  assert(!vertices.empty() && "vertex buffer is not mapped");
+  auto count =
+      std::min<uint64_t>(src.size() / components_of(T::getAttrType(attribute)),
+                         vertices.size() - firstVertex);
+  packAttribute(vertices.subspan(firstVertex, count), attribute, src);
+  buffer.flush(firstVertex * sizeof(T), count * sizeof(T));
+}
+
+} // namespace vkw
+#endif // VKWRAPPER_VERTEXPACKING_HPP
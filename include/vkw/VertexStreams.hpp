@@ -0,0 +1,178 @@
+#ifndef VKWRAPPER_VERTEXSTREAMS_HPP
+#define VKWRAPPER_VERTEXSTREAMS_HPP
+
+#include <vkw/Pipeline.hpp>
+#include <vkw/VertexBuffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace vkw {
+
+/**
+ * Conversion between separate attribute arrays (streams) and interleaved
+ * vertices described by AttributeArray.
+ *
+ * Stream i holds tightly packed values of attribute i, i.e. element size is
+ * size_of(T::getAttrType(i)). Attribute sizes and offsets are known at
+ * compile time, so every element is moved with a fixed size copy that
+ * compilers turn into plain vector loads and stores.
+ *
+ * Vertices are assembled block by block in a local buffer and written out
+ * with one sequential copy per block. This keeps writes to mapped, possibly
+ * write-combined, memory linear instead of striding over it once per
+ * attribute.
+ */
+
+namespace __detail {
+
+template <AttributeArray T> struct VertexBlock {
+  static constexpr size_t bytes = 4096;
+  static constexpr size_t vertices =
+      sizeof(T) >= bytes ? 1 : bytes / sizeof(T);
+};
+
+template <AttributeArray T, uint32_t attribute>
+inline void m_gatherAttribute(unsigned char const *stream,
+                              unsigned char *block, size_t count) noexcept {
+  constexpr auto size = size_of(T::getAttrType(attribute));
+  constexpr auto offset = attribute_offset<T>(attribute);
+  for (size_t i = 0; i < count; ++i)
+    std::memcpy(block + i * sizeof(T) + offset, stream + i * size, size);
+}
+
+template <AttributeArray T, uint32_t attribute>
+inline void m_scatterAttribute(unsigned char const *block,
+                               unsigned char *stream, size_t count) noexcept {
+  constexpr auto size = size_of(T::getAttrType(attribute));
+  constexpr auto offset = attribute_offset<T>(attribute);
+  for (size_t i = 0; i < count; ++i)
+    std::memcpy(stream + i * size, block + i * sizeof(T) + offset, size);
+}
+
+// Has no type member if there is no binding with given number.
+template <uint32_t binding, BindingPointDescriptionLike... Bindings>
+struct BindingOf {};
+
+template <uint32_t binding, BindingPointDescriptionLike First,
+          BindingPointDescriptionLike... Rest>
+struct BindingOf<binding, First, Rest...> {
+  using type = typename std::conditional_t<First::binding == binding,
+                                           std::type_identity<First>,
+                                           BindingOf<binding, Rest...>>::type;
+};
+
+} // namespace __detail
+
+/**
+ * Interleaves streams into vertices. streams must hold T::count() arrays of
+ * at least vertices.size() elements each.
+ */
+template <AttributeArray T>
+void interleave(std::span<const std::span<const unsigned char>> streams,
+                std::span<T> vertices) noexcept {
+  assert(streams.size() == T::count() && "stream count mismatch");
+  using Block = __detail::VertexBlock<T>;
+  alignas(16) unsigned char block[Block::vertices * sizeof(T)];
+  auto *out = reinterpret_cast<unsigned char *>(vertices.data());
+
+  for (size_t first = 0; first < vertices.size(); first += Block::vertices) {
+    auto count = std::min(Block::vertices, vertices.size() - first);
+    [&]<uint32_t... attrs>(std::integer_sequence<uint32_t, attrs...>) {
+      (__detail::m_gatherAttribute<T, attrs>(
+           streams[attrs].data() + first * size_of(T::getAttrType(attrs)),
+           block, count),
+       ...);
+    }(std::make_integer_sequence<uint32_t, T::count()>{});
+    std::memcpy(out + first * sizeof(T), block, count * sizeof(T));
+  }
+}
+
+/**
+ * Splits vertices into streams. streams must hold T::count() arrays of at
+ * least vertices.size() elements each.
+ */
+template <AttributeArray T>
+void deinterleave(std::span<const T> vertices,
+                  std::span<const std::span<unsigned char>> streams) noexcept {
+  assert(streams.size() == T::count() && "stream count mismatch");
+  using Block = __detail::VertexBlock<T>;
+  alignas(16) unsigned char block[Block::vertices * sizeof(T)];
+  auto const *in = reinterpret_cast<unsigned char const *>(vertices.data());
+
+  for (size_t first = 0; first < vertices.size(); first += Block::vertices) {
+    auto count = std::min(Block::vertices, vertices.size() - first);
+    std::memcpy(block, in + first * sizeof(T), count * sizeof(T));
+    [&]<uint32_t... attrs>(std::integer_sequence<uint32_t, attrs...>) {
+      (__detail::m_scatterAttribute<T, attrs>(
+           block,
+           streams[attrs].data() + first * size_of(T::getAttrType(attrs)),
+           count),
+       ...);
+    }(std::make_integer_sequence<uint32_t, T::count()>{});
+  }
+}
+
+/** Attribute layout of binding point with given number in input state. */
+template <typename InputState, uint32_t binding> struct binding_attributes;
+
+template <BindingPointDescriptionLike... Bindings, uint32_t binding>
+struct binding_attributes<VertexInputStateCreateInfo<Bindings...>, binding> {
+  using type =
+      typename __detail::BindingOf<binding, Bindings...>::type::Attributes;
+};
+
+template <typename InputState, uint32_t binding>
+using binding_attributes_t =
+    typename binding_attributes<InputState, binding>::type;
+
+/**
+ * Interleaves streams of binding from InputState into mapped vertex buffer
+ * starting from firstVertex and flushes written range. Vertex count is
+ * taken from the first stream.
+ *
+ * e.g.:
+ *    using Input = VertexInputStateCreateInfo<per_vertex<Vertex, 0>,
+ *                                             per_instance<Instance, 1>>;
+ *    interleaveBinding<Input, 0>(vertexStreams, vertexBuffer);
+ */
+template <typename InputState, uint32_t binding>
+void interleaveBinding(
+    std::span<const std::span<const unsigned char>> streams,
+    VertexBuffer<binding_attributes_t<InputState, binding>> &buffer,
+    uint64_t firstVertex = 0) noexcept(ExceptionsDisabled) {
+  using T = binding_attributes_t<InputState, binding>;
+  auto vertices = buffer.mapped();
+  assert(!vertices.empty() && "vertex buffer is not mapped");
+  auto count = streams.empty()
+                   ? 0
+                   : streams.front().size() / size_of(T::getAttrType(0));
+  count = std::min<uint64_t>(count, vertices.size() - firstVertex);
+  interleave(streams, vertices.subspan(firstVertex, count));
+  buffer.flush(firstVertex * sizeof(T), count * sizeof(T));
+}
+
+/**
+ * Splits count vertices of binding from InputState starting from firstVertex
+ * of mapped vertex buffer into streams. Buffer memory is invalidated first.
+ */
+template <typename InputState, uint32_t binding>
+void deinterleaveBinding(
+    VertexBuffer<binding_attributes_t<InputState, binding>> &buffer,
+    std::span<const std::span<unsigned char>> streams, uint64_t count,
+    uint64_t firstVertex = 0) noexcept(ExceptionsDisabled) {
+  using T = binding_attributes_t<InputState, binding>;
+  auto vertices = buffer.mapped();
+  assert(!vertices.empty() && "vertex buffer is not mapped");
+  assert(firstVertex + count <= vertices.size() && "range out of buffer");
+  buffer.invalidate(firstVertex * sizeof(T), count * sizeof(T));
+  deinterleave(std::span<const T>(vertices.subspan(firstVertex, count)),
+               streams);
+}
+
+} // namespace vkw
+#endif // VKWRAPPER_VERTEXSTREAMS_HPP
@@ -0,0 +1,109 @@
+import xml.etree.ElementTree as xmlReader
+import argparse
+
+
+class FormatDesc:
+    def __init__(self, format_node):
+        self.name = format_node.attrib['name']
+        self.block_size = format_node.attrib['blockSize']
+        self.texels_per_block = format_node.attrib['texelsPerBlock']
+        self.block_extent = format_node.attrib.get('blockExtent', '1,1,1').split(',')
+        self.compression = sanitize(format_node.attrib.get('compressed', 'NONE'))
+        self.bits = {'R': 0, 'G': 0, 'B': 0, 'A': 0, 'D': 0, 'S': 0}
+        self.numeric = 'NONE'
+        self.aspects = set()
+
+        for component in format_node.findall('component'):
+            name = component.attrib['name']
+            bits = component.attrib['bits']
+            if self.numeric == 'NONE':
+                self.numeric = sanitize(component.attrib['numericFormat'])
+            if name in self.bits and bits != 'compressed':
+                self.bits[name] = int(bits)
+            if name == 'D':
+                self.aspects.add('VK_IMAGE_ASPECT_DEPTH_BIT')
+            elif name == 'S':
+                self.aspects.add('VK_IMAGE_ASPECT_STENCIL_BIT')
+            else:
+                self.aspects.add('VK_IMAGE_ASPECT_COLOR_BIT')
+
+        planes = format_node.findall('plane')
+        self.plane_count = max(1, len(planes))
+        for plane in planes:
+            self.aspects.add('VK_IMAGE_ASPECT_PLANE_' + plane.attrib['index'] + '_BIT')
+
+    def generate(self):
+        return "VKW_FORMAT_ENTRY(" + ", ".join(
+            [self.name, self.block_size, self.texels_per_block] + self.block_extent +
+            [str(self.bits[c]) for c in 'RGBADS'] +
+            [' | '.join(sorted(self.aspects)), str(self.plane_count), self.compression,
+             self.numeric]) + ")\n"
+
+
+def sanitize(value):
+    return value.replace(' ', '_').upper()
+
+
+def collect_vulkan_formats(root):
+    # Only formats visible in vulkan_core.h are emitted: core ones, ones
+    # added by vulkan api versions and ones from non-platform extensions.
+    names = set()
+    for enums in root.findall('enums'):
+        if enums.attrib.get('name') != 'VkFormat':
+            continue
+        for enum in enums.findall('enum'):
+            names.add(enum.attrib['name'])
+
+    def collect_required(node):
+        for require in node.findall('require'):
+            for enum in require.findall('enum'):
+                if enum.attrib.get('extends') == 'VkFormat' and not enum.attrib.get('alias'):
+                    names.add(enum.attrib['name'])
+
+    for feature in root.findall('feature'):
+        if 'vulkan' in feature.attrib.get('api', 'vulkan').split(','):
+            collect_required(feature)
+
+    for extension in root.find('extensions').findall('extension'):
+        if not 'vulkan' in extension.attrib.get('supported', '').split(','):
+            continue
+        if extension.attrib.get('platform'):
+            continue
+        collect_required(extension)
+
+    return names
+
+
+if __name__ == '__main__':
+    args = argparse.ArgumentParser()
+
+    args.add_argument('-path', action='store', default='.',
+                      help='path to vk.xml')
+
+    parsed_args = args.parse_args()
+
+    doc = xmlReader.parse(parsed_args.path + '/vk.xml')
+    root = doc.getroot()
+
+    available = collect_vulkan_formats(root)
+
+    formats = [FormatDesc(node) for node in root.find('formats').findall('format')
+               if node.attrib['name'] in available]
+
+    compressions = []
+    numerics = []
+    for desc in formats:
+        if desc.compression != 'NONE' and desc.compression not in compressions:
+            compressions.append(desc.compression)
+        if desc.numeric != 'NONE' and desc.numeric not in numerics:
+            numerics.append(desc.numeric)
+
+    print("#ifdef VKW_DUMP_FORMAT_COMPRESSIONS")
+    print("".join("VKW_FORMAT_COMPRESSION_ENTRY(" + c + ")\n" for c in compressions))
+    print("#endif")
+    print("#ifdef VKW_DUMP_FORMAT_NUMERICS")
+    print("".join("VKW_FORMAT_NUMERIC_ENTRY(" + n + ")\n" for n in numerics))
+    print("#endif")
+    print("#ifdef VKW_DUMP_FORMATS")
+    print("".join(desc.generate() for desc in formats))
+    print("#endif")
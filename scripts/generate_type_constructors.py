@@ -9,6 +9,7 @@ class TypeDesc:
         self.constructor = ''
         self.destructor = ''
         self.createInfoType = ''
+        self.objectType = ''
 
     def generate(self):
         print('#ifdef VKW_GENERATE_TYPE_DEFINITIONS')
@@ -16,6 +17,7 @@ class TypeDesc:
         print('struct VulkanTypeTraits<' + self.type + '> {')
         print('   using CreatorType = ' + self.creator + ';')
         print('   using CreateInfoType = ' + self.createInfoType + ';')
+        print('   static constexpr VkObjectType objectType = ' + self.objectType + ';')
         print('   static PFN_' + self.constructor + ' getConstructor(' + self.creator + ' const& creator);')
         print('   static PFN_' + self.destructor + ' getDestructor(' + self.creator + ' const& creator);')
         print('};')
@@ -74,6 +76,15 @@ if __name__ == '__main__':
 
     types = []
     root = doc.getroot()
+
+    object_types = {}
+    for type_desc in root.find('types').findall('type'):
+        if type_desc.attrib.get('category') != 'handle':
+            continue
+        if type_desc.attrib.get('objtypeenum') is None:
+            continue
+        object_types[type_desc.find('name').text] = type_desc.attrib.get('objtypeenum')
+
     for command in filter(command_filter, root.find('commands')):
         if command.find('proto') is None:
             continue
@@ -88,4 +99,5 @@ if __name__ == '__main__':
             if core_command.attrib.get('name') == t.constructor:
                 for core_type in root.find('feature').iter('type'):
                     if core_type.attrib.get('name') == t.type:
+                        t.objectType = object_types[t.type]
                         t.generate()
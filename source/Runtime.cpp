@@ -5,9 +5,14 @@
 #include <vma/vk_mem_alloc.h>
 
 #ifdef _WIN32
+#include <windows.h>
 #include <Libloaderapi.h>
 #elif defined __linux__
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include "spirv-tools/linker.hpp"
@@ -15,6 +20,9 @@
 #include "vkw/Exception.hpp"
 
 #include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <memory>
 #include <span>
 
 namespace vkw {
@@ -192,6 +200,108 @@ void vkw_spvReflectDestroyShaderModule(SpvReflectShaderModule *p_module) {
   spvReflectDestroyShaderModule(p_module);
 }
 
+struct VKW_MappedFile_T {
+  const void *data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  HANDLE file = INVALID_HANDLE_VALUE;
+  HANDLE mapping = nullptr;
+#endif
+};
+
+VKW_ErrorCode vkw_mapFile(const char *path, VKW_MappedFile *handle,
+                          const void **data, size_t *size) try {
+  assert(path && handle && data && size);
+  *handle = nullptr;
+  auto mapped = std::make_unique<VKW_MappedFile_T>();
+  std::stringstream ss{};
+#ifdef _WIN32
+  mapped->file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+                               nullptr);
+  LARGE_INTEGER fileSize{};
+  if (mapped->file == INVALID_HANDLE_VALUE ||
+      !::GetFileSizeEx(mapped->file, &fileSize)) {
+    ss << "Failed to open " << path << ". Error code: 0x" << std::hex
+       << ::GetLastError();
+    if (mapped->file != INVALID_HANDLE_VALUE)
+      ::CloseHandle(mapped->file);
+    vkw::setErrorString(ss.str().c_str());
+    return VKW_FILE_MAP_FAILED;
+  }
+  mapped->size = static_cast<size_t>(fileSize.QuadPart);
+  if (mapped->size != 0) {
+    mapped->mapping = ::CreateFileMappingA(mapped->file, nullptr,
+                                           PAGE_READONLY, 0, 0, nullptr);
+    if (mapped->mapping)
+      mapped->data =
+          ::MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!mapped->data) {
+      ss << "Failed to map " << path << ". Error code: 0x" << std::hex
+         << ::GetLastError();
+      if (mapped->mapping)
+        ::CloseHandle(mapped->mapping);
+      ::CloseHandle(mapped->file);
+      vkw::setErrorString(ss.str().c_str());
+      return VKW_FILE_MAP_FAILED;
+    }
+  }
+#elif defined __linux__
+  auto fd = ::open(path, O_RDONLY | O_CLOEXEC);
+  struct stat fileStat {};
+  if (fd < 0 || ::fstat(fd, &fileStat) != 0) {
+    ss << "Failed to open " << path << ". Error message: "
+       << std::strerror(errno);
+    if (fd >= 0)
+      ::close(fd);
+    vkw::setErrorString(ss.str().c_str());
+    return VKW_FILE_MAP_FAILED;
+  }
+  mapped->size = static_cast<size_t>(fileStat.st_size);
+  if (mapped->size != 0) {
+    auto *ptr = ::mmap(nullptr, mapped->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      ss << "Failed to map " << path << ". Error message: "
+         << std::strerror(errno);
+      ::close(fd);
+      vkw::setErrorString(ss.str().c_str());
+      return VKW_FILE_MAP_FAILED;
+    }
+    // File contents are expected to be streamed front to back.
+    ::madvise(ptr, mapped->size, MADV_SEQUENTIAL);
+    mapped->data = ptr;
+  }
+  // Mapping stays valid after descriptor is closed.
+  ::close(fd);
+#else
+#error "unsupported platform"
+#endif
+  *data = mapped->data;
+  *size = mapped->size;
+  *handle = mapped.release();
+  return VKW_OK;
+} catch (...) {
+  return VKW_FATAL;
+}
+
+void vkw_unmapFile(VKW_MappedFile handle) {
+  if (!handle)
+    return;
+#ifdef _WIN32
+  if (handle->data)
+    ::UnmapViewOfFile(handle->data);
+  if (handle->mapping)
+    ::CloseHandle(handle->mapping);
+  ::CloseHandle(handle->file);
+#elif defined __linux__
+  if (handle->data)
+    ::munmap(const_cast<void *>(handle->data), handle->size);
+#else
+#error "unsupported platform"
+#endif
+  delete handle;
+}
+
 void *vkw_hostMalloc(size_t size, size_t alignment,
                      VkSystemAllocationScope scope) {
 #if _WIN32
@@ -0,0 +1,89 @@
+#include <iomanip>
+#include <iostream>
+#include <vkw/Buffer.hpp>
+#include <vkw/CommandPool.hpp>
+#include <vkw/DescriptorPool.hpp>
+#include <vkw/DescriptorSet.hpp>
+#include <vkw/Event.hpp>
+#include <vkw/Fence.hpp>
+#include <vkw/FrameBuffer.hpp>
+#include <vkw/Image.hpp>
+#include <vkw/Pipeline.hpp>
+#include <vkw/Query.hpp>
+#include <vkw/RenderPass.hpp>
+#include <vkw/Sampler.hpp>
+#include <vkw/Semaphore.hpp>
+#include <vkw/UniformBuffer.hpp>
+#include <vkw/VertexBuffer.hpp>
+
+// Reports size of wrapper objects next to size of handles they own. Build with
+// VKW_COMPACT_OBJECTS=ON to compare both layouts.
+
+#if defined(VKW_COMPACT_OBJECTS) && !defined(VKW_ENABLE_REFERENCE_GUARD)
+// Handle and creator reference, nothing else.
+static_assert(sizeof(vkw::vk::Sampler) <= 2 * sizeof(uint64_t));
+static_assert(sizeof(vkw::Semaphore) <= 2 * sizeof(uint64_t));
+// Handle, allocation, size and usage.
+static_assert(sizeof(vkw::BufferBase) <= 4 * sizeof(uint64_t));
+static_assert(sizeof(vkw::Buffer<float>) == sizeof(vkw::BufferBase));
+#endif
+
+namespace {
+
+template <typename T> void report(std::string_view name, size_t handleSize) {
+  std::cout << std::left << std::setw(40) << name << std::right
+            << std::setw(6) << sizeof(T) << std::setw(10)
+            << static_cast<double>(sizeof(T)) / handleSize << "x"
+            << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "compact objects: "
+#ifdef VKW_COMPACT_OBJECTS
+            << "on"
+#else
+            << "off"
+#endif
+            << ", reference guard: "
+#ifdef VKW_ENABLE_REFERENCE_GUARD
+            << "on"
+#else
+            << "off"
+#endif
+            << std::endl
+            << std::endl;
+
+  std::cout << std::left << std::setw(40) << "wrapper" << std::right
+            << std::setw(6) << "bytes" << std::setw(11) << "vs handle"
+            << std::endl;
+
+  report<vkw::StrongReference<vkw::Device const>>(
+      "StrongReference<Device const>", sizeof(void *));
+  report<vkw::vk::Sampler>("vk::Sampler (Unique<VkSampler>)",
+                           sizeof(VkSampler));
+  report<vkw::Sampler>("Sampler", sizeof(VkSampler));
+  report<vkw::Semaphore>("Semaphore", sizeof(VkSemaphore));
+  report<vkw::Fence>("Fence", sizeof(VkFence));
+  report<vkw::Event>("Event", sizeof(VkEvent));
+  report<vkw::QueryPool>("QueryPool", sizeof(VkQueryPool));
+  report<vkw::CommandPool>("CommandPool", sizeof(VkCommandPool));
+  report<vkw::DescriptorPool>("DescriptorPool", sizeof(VkDescriptorPool));
+  report<vkw::DescriptorSet>("DescriptorSet", sizeof(VkDescriptorSet));
+  report<vkw::PipelineLayout>("PipelineLayout", sizeof(VkPipelineLayout));
+  report<vkw::GraphicsPipeline>("GraphicsPipeline", sizeof(VkPipeline));
+  report<vkw::RenderPass>("RenderPass", sizeof(VkRenderPass));
+  report<vkw::FrameBuffer>("FrameBuffer", sizeof(VkFramebuffer));
+  report<vkw::Buffer<float>>("Buffer<float>", sizeof(VkBuffer));
+  report<vkw::UniformBuffer<float>>("UniformBuffer<float>", sizeof(VkBuffer));
+  report<vkw::IndexBuffer<VK_INDEX_TYPE_UINT32>>("IndexBuffer<UINT32>",
+                                                 sizeof(VkBuffer));
+  report<vkw::IndirectBuffer<VkDrawIndirectCommand>>(
+      "IndirectBuffer<VkDrawIndirectCommand>", sizeof(VkBuffer));
+  report<vkw::Image<vkw::COLOR, vkw::I2D>>("Image<COLOR, I2D>",
+                                           sizeof(VkImage));
+  report<vkw::ImageView<vkw::COLOR, vkw::V2D>>("ImageView<COLOR, V2D>",
+                                               sizeof(VkImageView));
+  return 0;
+}